@@ -41,33 +41,160 @@
  * See http://www.freertos.org/a00110.html.
  *----------------------------------------------------------*/
 #define configMTIME_BASE_ADDRESS                ( NEORV32_CLINT_BASE + 0xbff8u )
-#define configMTIMECMP_BASE_ADDRESS             ( NEORV32_CLINT_BASE + 0x4000u )
+#define configMTIMECMP_BASE_ADDRESS             ( 0 ) // tick increment is set up at run time (tick.c)
 #define configISR_STACK_SIZE_WORDS              ( 256 )
 #define configUSE_PREEMPTION                    ( 1 )
 #define configUSE_IDLE_HOOK                     ( 1 )
 #define configUSE_TICK_HOOK                     ( 1 )
-#define configCPU_CLOCK_HZ                      ( 100000000 )
+#ifndef configCPU_CLOCK_HZ
+  #define configCPU_CLOCK_HZ                    ( 100000000 ) // nominal only; the actual clock is ulPlatformClockHz (platform.c)
+#endif
 #define configTICK_RATE_HZ                      ( (TickType_t)(100) )
-#define configMAX_PRIORITIES                    ( 5 )
-#define configMINIMAL_STACK_SIZE                ( (unsigned short)(128) )
+#ifndef configMAX_PRIORITIES
+  #define configMAX_PRIORITIES                  ( 5 ) // up to 32; constant-time selection via clz (platform.c)
+#endif
+#ifdef __riscv_32e
+  #define configMINIMAL_STACK_SIZE              ( (unsigned short)(112 + configPMP_STACK_GUARD_WORDS) ) // RV32E: 16 words less context
+#else
+  #define configMINIMAL_STACK_SIZE              ( (unsigned short)(128 + configPMP_STACK_GUARD_WORDS) )
+#endif
 #define configTOTAL_HEAP_SIZE                   ( (size_t)(4096) )
+#define configSTACK_DEPTH_TYPE                  uint32_t
 #define configMAX_TASK_NAME_LEN                 ( 16 )
-#define configUSE_TRACE_FACILITY                ( 0 )
+#define configUSE_TRACE_FACILITY                ( 1 )
 #define configUSE_16_BIT_TICKS                  ( 0 )
 #define configIDLE_SHOULD_YIELD                 ( 0 )
 #define configUSE_MUTEXES                       ( 1 )
 #define configQUEUE_REGISTRY_SIZE               ( 8 )
-#define configCHECK_FOR_STACK_OVERFLOW          ( 2 )
 #define configUSE_RECURSIVE_MUTEXES             ( 1 )
 #define configUSE_MALLOC_FAILED_HOOK            ( 1 )
 #define configUSE_APPLICATION_TASK_TAG          ( 0 )
 #define configUSE_COUNTING_SEMAPHORES           ( 1 )
-#define configGENERATE_RUN_TIME_STATS           ( 0 )
-#define configUSE_PORT_OPTIMISED_TASK_SELECTION ( 1 )
+#ifndef configGENERATE_RUN_TIME_STATS
+  #define configGENERATE_RUN_TIME_STATS         ( 1 )
+#endif
+#ifndef configNUMBER_OF_CORES
+  #define configNUMBER_OF_CORES                 ( 1 )
+#endif
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+  #if ( configNUMBER_OF_CORES > 1 )
+    #define configUSE_PORT_OPTIMISED_TASK_SELECTION ( 0 )
+  #else
+    #define configUSE_PORT_OPTIMISED_TASK_SELECTION ( 1 )
+  #endif
+#endif
 #define configUSE_QUEUE_SETS                    ( 1 )
-#define configTASK_NOTIFICATION_ARRAY_ENTRIES   ( 4 )
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   ( 8 )
+
+/* Dual-core SMP (smp/port.c, "make SMP=1"). Tasks run on hart 0 unless they are created with an
+ * affinity that includes hart 1 (xTaskCreateAffinitySet()); the demo's drivers, interrupt handlers
+ * and single-core features stay on hart 0. */
+#if ( configNUMBER_OF_CORES > 1 )
+  #define configRUN_MULTIPLE_PRIORITIES         ( 1 )
+  #define configUSE_CORE_AFFINITY               ( 1 )
+  #define configTASK_DEFAULT_CORE_AFFINITY      ( 1 << 0 )
+  #define configUSE_PASSIVE_IDLE_HOOK           ( 0 )
+  #define configUSE_TASK_PREEMPTION_DISABLE     ( 0 )
+  #define configMSIP_BASE_ADDRESS               ( NEORV32_CLINT_BASE )
+  #define configUSE_TICKLESS_IDLE               ( 0 )
+#endif
+
+/* Tickless idle using the CLINT MTIME timer (tickless.c). */
+#ifndef configUSE_TICKLESS_IDLE
+  #define configUSE_TICKLESS_IDLE               ( 1 )
+#endif
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   ( 2 )
+void vPortSuppressTicksAndSleep( uint32_t xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+
+/* Run-time statistics (runtime_stats.c): 64-bit counter based on MTIME (default) or mcycle. */
+#define configRUN_TIME_COUNTER_TYPE             uint64_t
+#define configRUN_TIME_STATS_USE_MCYCLE         ( 0 )
+uint64_t ullRuntimeStatsGetCounter( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        ullRuntimeStatsGetCounter()
+
+/* CPU load monitor task (runtime_stats.c). */
+#ifndef configUSE_STATS_MONITOR
+  #define configUSE_STATS_MONITOR               ( 0 )
+#endif
+#define configSTATS_MONITOR_PERIOD_MS           ( 5000 )
+#define configSTATS_MONITOR_PRIORITY            ( tskIDLE_PRIORITY + 1 )
+#define configSTATS_MONITOR_MAX_TASKS           ( 8 )
 
-/* Co-routine definitions. */
+/* Stack high-water-mark monitor (stack_monitor.c). */
+#define configRECORD_STACK_HIGH_ADDRESS         ( 1 )
+#ifndef configUSE_STACK_MONITOR
+  #define configUSE_STACK_MONITOR               ( 0 )
+#endif
+#ifndef configSTACK_MONITOR_PERIOD_MS
+  #define configSTACK_MONITOR_PERIOD_MS         ( 10000 )
+#endif
+#define configSTACK_MONITOR_PRIORITY            ( tskIDLE_PRIORITY + 1 )
+#define configSTACK_MONITOR_MAX_TASKS           ( 8 )
+
+/* Stack overflow detection: software check (pattern compare on every context switch, default) and optional
+ * PMP-based hardware stack guard (stack_guard.c); the guard requires U-mode and >= 3 PMP regions. The trap
+ * entry pushes the context frame (128 bytes, RV32E: 64 bytes) unchecked, so the guard has to cover this frame
+ * plus the largest stack frame of any function; keep the software check enabled to catch pushes beyond it.
+ * The guard is added to configMINIMAL_STACK_SIZE; it has to be added to all other task stacks as well. */
+#ifndef configCHECK_FOR_STACK_OVERFLOW
+  #define configCHECK_FOR_STACK_OVERFLOW        ( 2 )
+#endif
+#ifndef configUSE_PMP_STACK_GUARD
+  #define configUSE_PMP_STACK_GUARD             ( 0 )
+#endif
+#ifndef configPMP_STACK_GUARD_SIZE
+  #define configPMP_STACK_GUARD_SIZE            ( 256 )
+#endif
+#if ( configUSE_PMP_STACK_GUARD == 1 )
+  #define configPMP_STACK_GUARD_WORDS           ( configPMP_STACK_GUARD_SIZE / 4 )
+#else
+  #define configPMP_STACK_GUARD_WORDS           ( 0 )
+#endif
+
+/* Kernel object allocation: dynamic (heap_5, default) or fully static ("make ALLOCATION=static").
+ * Static kernel objects are placed in the .freertos_static section (freertos_static.ld). The heap consists
+ * of configTOTAL_HEAP_SIZE bytes plus all DMEM beyond RAM_SIZE that is detected at run time (platform.c). */
+#ifndef configSUPPORT_STATIC_ALLOCATION
+  #define configSUPPORT_STATIC_ALLOCATION       ( 0 )
+#endif
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  #define configSUPPORT_DYNAMIC_ALLOCATION      ( 0 )
+#else
+  #define configSUPPORT_DYNAMIC_ALLOCATION      ( 1 )
+#endif
+
+/* Cache-aware placement (cache.c): align kernel objects to cache lines ("make CACHE=on"): all static objects
+ * (configSTATIC_DATA) or the task stacks of dynamically created tasks (pvPortMallocStack()). */
+#ifndef configUSE_CACHE_ALIGNMENT
+  #define configUSE_CACHE_ALIGNMENT             ( 0 )
+#endif
+#define configCACHE_LINE_SIZE                   ( 64 )
+#if ( configUSE_CACHE_ALIGNMENT == 1 )
+  #define configSTATIC_DATA                     __attribute__((section(".freertos_static"), aligned(configCACHE_LINE_SIZE)))
+  #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    #define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP ( 1 )
+  #endif
+#else
+  #define configSTATIC_DATA                     __attribute__((section(".freertos_static"), aligned(16)))
+#endif
+
+/* Hot data in the uncached DMEM while .data/.bss are in cached external memory ("make SCRATCHPAD=1",
+ * scratchpad.ld). Only zero-initialized objects may be placed in the scratchpad. */
+#ifndef configUSE_SCRATCHPAD
+  #define configUSE_SCRATCHPAD                  ( 0 )
+#endif
+#define configSCRATCHPAD_DATA                   __attribute__((section(".scratchpad")))
+
+/* Code placement: all code in IMEM (default) or in XIP flash with the kernel fast path and all functions
+ * marked with configFAST_TEXT copied to IMEM at startup ("make PLACEMENT=xip", fast_text.ld). */
+#ifndef configFAST_TEXT_COPY
+  #define configFAST_TEXT_COPY                  ( 0 )
+#endif
+#define configFAST_TEXT                         __attribute__((section(".text.fast")))
+
+/* Co-routine definitions (the kernel's co-routines are not used, see coro.c for stackless coroutines). */
 #define configUSE_CO_ROUTINES                   ( 0 )
 #define configMAX_CO_ROUTINE_PRIORITIES         ( 2 )
 
@@ -82,6 +209,80 @@
   #define uartPRIMARY_PRIORITY                  ( configMAX_PRIORITIES - 3 )
 #endif
 
+/* UART0 console driver (console.c). Buffer sizes have to be a power of two. */
+#define configCONSOLE_TX_BUFFER_SIZE            ( 256 )
+#define configCONSOLE_RX_BUFFER_SIZE            ( 64 )
+#define configCONSOLE_PRINTF_BUFFER_SIZE        ( 96 )
+#define configCONSOLE_NOTIFY_INDEX              ( 1 )
+
+/* FIRQ dispatcher (irq.c): notification index used to wake deferred handler tasks. */
+#define configIRQ_NOTIFY_INDEX                  ( 2 )
+
+/* Interrupt nesting (irq.c, irq_nest.S, "make IRQ_NESTING=1"): handlers can be preempted by channels of a
+ * higher priority (vNeorv32IrqSetPriority(), 0..configIRQ_PRIORITIES-1). The FromISR API masks interrupts
+ * then (portmacro.h). Single-core port only. */
+#ifndef configUSE_IRQ_NESTING
+  #define configUSE_IRQ_NESTING                 ( 0 )
+#endif
+#define configIRQ_PRIORITIES                    ( 4 )
+#if ( configUSE_IRQ_NESTING == 1 ) && ( configNUMBER_OF_CORES > 1 )
+  #error "Interrupt nesting (configUSE_IRQ_NESTING) is not supported by the SMP port"
+#endif
+
+/* Zero-copy channels (bufpool.c): notification index used to wake the receiving task. */
+#define configCHANNEL_NOTIFY_INDEX              ( 3 )
+
+/* High-resolution timer service (hrtimer.c): GPTMR slice used for the deadline queue and notification index
+ * used to wake the tasks of deferred timers. */
+#define configHRTIMER_GPTMR_SLICE               ( 0 )
+#define configHRTIMER_NOTIFY_INDEX              ( 4 )
+
+/* DMA driver (dma.c): notification index used to wake tasks waiting for a transfer. */
+#define configDMA_NOTIFY_INDEX                  ( 5 )
+
+/* Stackless coroutines (coro.c): notification index used to wake the executor task and poll period of
+ * coroutines waiting for a queue (0 = no polling; queues shared with tasks / ISRs use the xCoroQueue*()
+ * wrappers). */
+#define configCORO_NOTIFY_INDEX                 ( 6 )
+#define configCORO_POLL_TICKS                   ( 0 )
+
+/* Lock-free primitives (lockfree.c): notification index used to wake a task waiting for an event-bit word. */
+#define configEVENT_WORD_NOTIFY_INDEX           ( 7 )
+
+/* Deferred binary logging (binlog.c). Ring sizes (in words) have to be a power of two. */
+#ifndef configUSE_BINLOG
+  #define configUSE_BINLOG                      ( 1 )
+#endif
+#define configBINLOG_ISR_RING_WORDS             ( 64 )
+#define configBINLOG_TASK_RING_WORDS            ( 64 )
+#define configBINLOG_TASK_PRIORITY              ( tskIDLE_PRIORITY + 1 )
+#define configBINLOG_FLUSH_PERIOD_MS            ( 100 )
+
+/* Kernel event trace recorder (trace.c). Buffer size (in records) has to be a power of two. */
+#ifndef configUSE_TRACE_RECORDER
+  #define configUSE_TRACE_RECORDER              ( 0 )
+#endif
+#define configTRACE_BUFFER_RECORDS              ( 128 )
+#define configTRACE_MAX_TASKS                   ( 8 )
+#ifndef configTRACE_DUMP_PERIOD_MS
+  #define configTRACE_DUMP_PERIOD_MS            ( 0 )
+#endif
+
+/* PC-sampling profiler (profiler.c): sample rate, GPTMR slice (shared interrupt with the timer service) and
+ * histogram size (in buckets of 8 bytes, power of two). */
+#ifndef configUSE_PROFILER
+  #define configUSE_PROFILER                    ( 0 )
+#endif
+#ifndef configPROFILER_RATE_HZ
+  #define configPROFILER_RATE_HZ                ( 1000 )
+#endif
+#define configPROFILER_GPTMR_SLICE              ( 1 )
+#define configPROFILER_BUCKETS                  ( 256 )
+#define configPROFILER_MAX_TASKS                ( 16 )
+#ifndef configPROFILER_DUMP_PERIOD_MS
+  #define configPROFILER_DUMP_PERIOD_MS         ( 10000 )
+#endif
+
 /* Set the following definitions to 1 to include the API function, or zero to exclude the API function. */
 #define INCLUDE_vTaskPrioritySet                ( 1 )
 #define INCLUDE_uxTaskPriorityGet               ( 1 )
@@ -95,12 +296,20 @@
 #define INCLUDE_xTaskAbortDelay                 ( 1 )
 #define INCLUDE_xTaskGetHandle                  ( 1 )
 #define INCLUDE_xSemaphoreGetMutexHolder        ( 1 )
+#define INCLUDE_xTaskGetSchedulerState          ( 1 )
+#define INCLUDE_xTaskGetCurrentTaskHandle       ( 1 )
+#define INCLUDE_xTaskGetIdleTaskHandle          ( 1 )
 
 /* Normal assert() semantics without relying on the provision of an assert.h header file. */
 void vAssertCalled( void );
 #define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled()
 
-/* Map to the platform's write function. */
+/* Map to the platform's (non-blocking) write function. */
+void vSendString( const char * pcString );
 #define configPRINT_STRING( pcString )          vSendString( pcString )
 
+/* Kernel trace hooks (the stack guard's switch hook is called by trace.h). */
+#include "stack_guard.h"
+#include "trace.h"
+
 #endif /* FREERTOS_CONFIG_H */
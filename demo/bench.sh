@@ -0,0 +1,55 @@
+#!/usr/bin/env bash
+
+# Run the kernel micro-benchmarks (benchmark.c) in simulation and compare the
+# results against a baseline.
+#   bench.sh               compare against benchmark_baseline.txt (has to exist)
+#   bench.sh --update      store the current results as new baseline
+#   bench.sh --base <rev>  simulate git revision <rev> first and compare against its results; falls back
+#                          to benchmark_baseline.txt (or only runs the benchmarks if there is none) if
+#                          <rev> has no benchmark application
+
+set -e
+
+cd $(dirname "$0")
+
+ROOT=$(cd .. && pwd)
+HOMES="NEORV32_HOME=$ROOT/neorv32 FREERTOS_HOME=$ROOT/FreeRTOS-Kernel"
+BASELINE=benchmark_baseline.txt
+
+# build and simulate the benchmark application of the demo folder $1
+run_bench() {
+  # compile benchmark application and install executable as persistent memory image
+  make -C "$1" $HOMES USER_FLAGS+="-DUART0_SIM_MODE" APP=benchmark clean_all exe install
+  # simulate (-i to ignore the non-zero return code from GHDL when time-terminating)
+  rm -f $ROOT/neorv32/sim/ghdl.log
+  make -C "$1" $HOMES -i GHDL_RUN_FLAGS="--stop-time=10ms" sim
+}
+
+OPTIONAL=0
+if [ "$1" = "--base" ]; then
+  BASE_DIR=$(mktemp -d)
+  trap 'git worktree remove --force "$BASE_DIR/src"; rm -rf "$BASE_DIR"' EXIT
+  git worktree add --detach "$BASE_DIR/src" "$2"
+  if [ -f "$BASE_DIR/src/demo/benchmark.c" ]; then
+    run_bench "$BASE_DIR/src/demo"
+    BASELINE=$BASE_DIR/baseline.log
+    cp $ROOT/neorv32/sim/ghdl.log $BASELINE
+  else
+    echo "[bench] NOTE: revision $2 has no benchmark application, using $BASELINE instead"
+    OPTIONAL=1
+  fi
+  shift 2
+fi
+
+run_bench .
+
+# no baseline to compare against: only check that the run completed
+if [ $OPTIONAL -eq 1 ] && [ ! -f $BASELINE ]; then
+  echo "[bench] NOTE: no $BASELINE either, skipping the comparison"
+  grep "#BENCH" ../neorv32/sim/ghdl.log
+  grep -q "#BENCH-END" ../neorv32/sim/ghdl.log
+  exit 0
+fi
+
+# check results
+python3 tools/bench_compare.py ../neorv32/sim/ghdl.log $BASELINE "$@"
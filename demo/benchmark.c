@@ -0,0 +1,944 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Kernel micro-benchmarks
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Measures the cost of basic kernel operations in CPU cycles (mcycle). Every
+ * test is repeated configBENCH_ITERATIONS times; the overhead of reading the
+ * cycle counter is subtracted. Results are printed as one line per test:
+ *
+ *   #BENCH:<name> <min> <avg> <max>
+ *
+ * followed by "#BENCH-END". bench.sh runs this application in simulation and
+ * compares the results against benchmark_baseline.txt (tools/bench_compare.py).
+ * The configuration is reported as "#BENCH-CFG:icache=<0|1> dcache=<0|1>
+ * line=<bytes> priorities=<n> zbb=<0|1> atomics=<0|1>" (see cache_bench.sh,
+ * prio_bench.sh).
+ *
+ * ctx_select measures a taskYIELD() that selects the calling task again (no
+ * other task is ready at its priority): the yield trap plus the ready-list
+ * lookup, stack check and switch hooks, without a switch to another task;
+ * prio_bench.sh compares it for different configMAX_PRIORITIES.
+ *
+ * coro_switch measures the hand-over from one stackless coroutine (coro.c)
+ * to another one via an event, the coroutine equivalent of notify_wake. The
+ * memory needed per unit of concurrency is reported as "#BENCH-MEM:coro=<n>
+ * task=<n>" (bytes of a Coro_t vs. TCB plus minimal stack).
+ *
+ * The frame_* tests compare passing a configBENCH_FRAME_SIZE bytes frame to a
+ * consumer task via a (copying) queue, a (copying) stream buffer and a
+ * zero-copy channel (bufpool.c).
+ *
+ * isr_wake measures the latency from a high-resolution timer callback
+ * (hrtimer.c, interrupt context) to the woken task; hrtimer_late the latency
+ * from the timer's deadline to its callback.
+ *
+ * irq_lat_flat / irq_lat_nested measure the worst-case interrupt latency
+ * (MTIME cycles from deadline to callback) of a periodic high-resolution
+ * timer while a slow handler (benchIRQ_LOAD_US) is triggered repeatedly via
+ * the software interrupt (single-core only). irq_lat_flat runs the GPTMR at
+ * the same priority as the slow handler; irq_lat_nested (only with
+ * "make IRQ_NESTING=1") gives it a higher priority so it preempts the slow
+ * handler (see irq.h).
+ *
+ * atomic_critical / atomic_add compare a shared counter increment using a
+ * kernel critical section and using lockfree.h (amoadd with the A
+ * extension, a short masked section otherwise); ring_spsc / ring_mpsc are a
+ * push plus pop of the lock-free rings. irq_lat_queue / irq_lat_lockfree
+ * measure the worst-case timer interrupt latency while the benchmark task
+ * keeps sending and receiving using a kernel queue (critical sections) and
+ * using the MPSC ring (no disabled interrupts with atomics). The
+ * configuration line reports atomics=<0|1>.
+ *
+ * The copy_* tests copy a configBENCH_COPY_SIZE bytes block using the CPU
+ * (memcpy) and using the DMA controller (dma.c, submit until the task is
+ * woken by the completion interrupt). dma_submit is the CPU time needed to
+ * start a DMA transfer; the CPU is free for other tasks for the rest of the
+ * copy_dma time except for the completion interrupt.
+ *
+ * uart_irq / uart_dma send a configBENCH_UART_SIZE bytes line ("#BENCH-TX:")
+ * via the console using the TX interrupt (ring buffer, one interrupt per
+ * FIFO refill) and using the DMA (xConsoleWriteDma(), FIFO-sized chunks)
+ * until it has left the TX FIFO. A lowest-priority task meanwhile counts the
+ * cycles it gets; the share the CPU was not available to it is reported as
+ * "#BENCH-UTIL:<name> busy=<percent>".
+ *
+ * Select this application using "make APP=benchmark ...".
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <semphr.h>
+#include <stream_buffer.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Console, high-resolution timers, DMA and buffer pool */
+#include "console.h"
+#include "hrtimer.h"
+#include "dma.h"
+#include "bufpool.h"
+#include "cache.h"
+#include "platform.h"
+#include "irq.h"
+#include "coro.h"
+#include "lockfree.h"
+
+/* Number of iterations per test */
+#ifndef configBENCH_ITERATIONS
+  #define configBENCH_ITERATIONS ( 16 )
+#endif
+
+/* Task priorities (relative to the benchmark task) */
+#define benchPRIORITY       ( configMAX_PRIORITIES - 3 )
+#define benchLOW_PRIORITY   ( benchPRIORITY - 1 )
+#define benchHIGH_PRIORITY  ( benchPRIORITY + 1 )
+
+/* Frame size for the message passing tests (queue vs. stream buffer vs. zero-copy channel) */
+#ifndef configBENCH_FRAME_SIZE
+  #define configBENCH_FRAME_SIZE ( 128 )
+#endif
+
+/* Block size for the memory copy tests (CPU vs. DMA) */
+#ifndef configBENCH_COPY_SIZE
+  #define configBENCH_COPY_SIZE ( 256 )
+#endif
+
+/* Line length for the console output tests (interrupt vs. DMA) */
+#ifndef configBENCH_UART_SIZE
+  #define configBENCH_UART_SIZE ( 64 )
+#endif
+
+/* Console output tests: number of lines; longest gap (cycles) of the idle meter loop that still counts as idle */
+#define benchUART_ROUNDS      ( 4 )
+#define benchMETER_GAP        ( 64 )
+
+/* Timer delay for the ISR tests; long enough for the benchmark task to block */
+#define benchHRTIMER_DELAY_US ( 50 )
+
+/* Interrupt latency tests: timer period and duration of the slow (software interrupt) handler */
+#define benchIRQ_PERIOD_US    ( 50 )
+#define benchIRQ_LOAD_US      ( 20 )
+
+/* Result accumulator */
+typedef struct {
+  uint32_t ulMin;
+  uint32_t ulMax;
+  uint32_t ulSum;
+  uint32_t ulCount;
+} BenchResult_t;
+
+/* Memory for the kernel objects if they are created statically; there is only
+ * one helper task and one semaphore at a time */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+static StaticTask_t xBenchTCB configSTATIC_DATA;
+static StackType_t xBenchStack[configMINIMAL_STACK_SIZE + 64] configSTATIC_DATA;
+static StaticTask_t xHelperTCB configSTATIC_DATA;
+static StackType_t xHelperStack[configMINIMAL_STACK_SIZE] configSTATIC_DATA;
+static StaticQueue_t xQueueBuffers[2] configSTATIC_DATA;
+static uint8_t ucQueueStorage[2][sizeof(uint32_t)] configSTATIC_DATA;
+static StaticSemaphore_t xSemaphoreBuffer configSTATIC_DATA;
+static StaticQueue_t xFrameQueueBuffer configSTATIC_DATA;
+static StaticStreamBuffer_t xFrameStreamBuffer configSTATIC_DATA;
+static uint8_t ucFrameStorage[configBENCH_FRAME_SIZE + 1] configSTATIC_DATA; // used by one test at a time
+  #define benchQUEUE_CREATE(n)   xQueueCreateStatic(1, sizeof(uint32_t), ucQueueStorage[n], &xQueueBuffers[n])
+  #define benchBINARY_CREATE()   xSemaphoreCreateBinaryStatic(&xSemaphoreBuffer)
+  #define benchMUTEX_CREATE()    xSemaphoreCreateMutexStatic(&xSemaphoreBuffer)
+  #define benchFRAME_QUEUE_CREATE()  xQueueCreateStatic(1, configBENCH_FRAME_SIZE, ucFrameStorage, &xFrameQueueBuffer)
+  #define benchFRAME_STREAM_CREATE() xStreamBufferCreateStatic(configBENCH_FRAME_SIZE, configBENCH_FRAME_SIZE, ucFrameStorage, &xFrameStreamBuffer)
+#else
+  #define benchQUEUE_CREATE(n)   xQueueCreate(1, sizeof(uint32_t))
+  #define benchBINARY_CREATE()   xSemaphoreCreateBinary()
+  #define benchMUTEX_CREATE()    xSemaphoreCreateMutex()
+  #define benchFRAME_QUEUE_CREATE()  xQueueCreate(1, configBENCH_FRAME_SIZE)
+  #define benchFRAME_STREAM_CREATE() xStreamBufferCreate(configBENCH_FRAME_SIZE, configBENCH_FRAME_SIZE)
+#endif
+
+/* Shared state */
+static TaskHandle_t xBenchTask = NULL;
+static TaskHandle_t xHelperTask = NULL;
+static QueueHandle_t xQueueTo = NULL, xQueueFrom = NULL;
+static volatile uint32_t ulStamp = 0;
+static volatile uint32_t ulLateness = 0;
+static HrTimer_t xTimer;
+
+/* Coroutine test */
+static Coro_t xCoroPing, xCoroPong;
+static BenchResult_t xCoroResult;
+static uint32_t ulCoroRounds = 0;
+
+/* Lock-free tests */
+static volatile uint32_t ulCounter = 0;
+static uint32_t ulSpscSlots[4];
+static void *pvMpscSlots[4];
+static SpscRing_t xSpscRing;
+static MpscRing_t xMpscRing;
+
+/* Interrupt latency tests */
+static BenchResult_t xIrqLatency;
+static volatile uint32_t ulIrqSamples = 0;
+
+/* Message passing tests */
+static QueueHandle_t xFrameQueue = NULL;
+static StreamBufferHandle_t xFrameStream = NULL;
+static bufpoolSTORAGE(ulFramePoolStorage, configBENCH_FRAME_SIZE, 2);
+static BufPool_t xFramePool;
+static void *pvFrameSlots[2];
+static Channel_t xFrameChannel;
+static uint8_t ucFrame[configBENCH_FRAME_SIZE];
+
+/* Memory copy tests */
+static uint32_t ulCopySource[configBENCH_COPY_SIZE / sizeof(uint32_t)];
+static uint32_t ulCopyDestination[configBENCH_COPY_SIZE / sizeof(uint32_t)];
+static uint32_t ulOverhead = 0;
+
+/* Console output tests */
+#if ( configNUMBER_OF_CORES == 1 )
+static char cUartLine[configBENCH_UART_SIZE];
+static volatile uint32_t ulIdleCycles = 0;
+#endif
+
+/* Prototypes */
+void benchmark(void);
+static void prvBenchTask(void *pvParameters);
+static inline uint32_t prvCycles(void);
+static void prvStart(BenchResult_t *pxResult);
+static void prvAdd(BenchResult_t *pxResult, uint32_t ulCycles);
+static void prvReport(const char *pcName, const BenchResult_t *pxResult);
+static BaseType_t prvCreateHelper(TaskFunction_t pxFunction, const char *pcName, UBaseType_t uxPriority);
+static void prvYieldHelper(void *pvParameters);
+static void prvResumeHelper(void *pvParameters);
+static void prvNotifyHelper(void *pvParameters);
+static void prvQueueHelper(void *pvParameters);
+static void prvFrameQueueHelper(void *pvParameters);
+static void prvFrameStreamHelper(void *pvParameters);
+static void prvFrameChannelHelper(void *pvParameters);
+static void prvCoroHelper(void *pvParameters);
+static void prvCoroPing(Coro_t *pxCoro);
+static void prvCoroPong(Coro_t *pxCoro);
+static void prvTimerCallback(void *pvContext);
+#if ( configNUMBER_OF_CORES == 1 )
+static void prvSpin(uint32_t ulUs);
+static void prvSlowIrqHandler(void *pvContext);
+static void prvLatencyCallback(void *pvContext);
+static void prvIrqLatency(const char *pcName, void (*pxLoad)(uint32_t ulRound));
+static void prvMsiLoad(uint32_t ulRound);
+static void prvQueueLoad(uint32_t ulRound);
+static void prvLockFreeLoad(uint32_t ulRound);
+static void prvIdleMeterHelper(void *pvParameters);
+static void prvUartOutput(const char *pcName, BaseType_t xUseDma);
+#endif
+
+
+/******************************************************************************
+ * Create the benchmark task and start the scheduler.
+ ******************************************************************************/
+void benchmark(void) {
+
+  xQueueTo = benchQUEUE_CREATE(0);
+  xQueueFrom = benchQUEUE_CREATE(1);
+
+  if ((xQueueTo != NULL) && (xQueueFrom != NULL)) {
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    xBenchTask = xTaskCreateStatic(prvBenchTask, "Bench", configMINIMAL_STACK_SIZE + 64, NULL, benchPRIORITY, xBenchStack, &xBenchTCB);
+#else
+    xTaskCreate(prvBenchTask, "Bench", configMINIMAL_STACK_SIZE + 64, NULL, benchPRIORITY, &xBenchTask);
+#endif
+    vTaskStartScheduler();
+  }
+
+  for (;;);
+}
+
+
+/******************************************************************************
+ * Read low word of the cycle counter.
+ ******************************************************************************/
+static inline uint32_t prvCycles(void) {
+
+  return neorv32_cpu_csr_read(CSR_MCYCLE);
+}
+
+
+/******************************************************************************
+ * Result handling.
+ ******************************************************************************/
+static void prvStart(BenchResult_t *pxResult) {
+
+  pxResult->ulMin = 0xffffffffu;
+  pxResult->ulMax = 0;
+  pxResult->ulSum = 0;
+  pxResult->ulCount = 0;
+}
+
+static void prvAdd(BenchResult_t *pxResult, uint32_t ulCycles) {
+
+  ulCycles = (ulCycles > ulOverhead) ? (ulCycles - ulOverhead) : 0;
+
+  if (ulCycles < pxResult->ulMin) {
+    pxResult->ulMin = ulCycles;
+  }
+  if (ulCycles > pxResult->ulMax) {
+    pxResult->ulMax = ulCycles;
+  }
+  pxResult->ulSum += ulCycles;
+  pxResult->ulCount++;
+}
+
+static void prvReport(const char *pcName, const BenchResult_t *pxResult) {
+
+  if (pxResult->ulCount == 0) {
+    return;
+  }
+  vConsolePrintfBlocking("#BENCH:%s %u %u %u\n", pcName, (unsigned)pxResult->ulMin,
+                         (unsigned)(pxResult->ulSum / pxResult->ulCount), (unsigned)pxResult->ulMax);
+}
+
+
+/******************************************************************************
+ * Create the helper task of a test (deleted again at the end of the test).
+ ******************************************************************************/
+static BaseType_t prvCreateHelper(TaskFunction_t pxFunction, const char *pcName, UBaseType_t uxPriority) {
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  xHelperTask = xTaskCreateStatic(pxFunction, pcName, configMINIMAL_STACK_SIZE, NULL, uxPriority, xHelperStack, &xHelperTCB);
+  return (xHelperTask != NULL) ? pdPASS : pdFAIL;
+#else
+  return xTaskCreate(pxFunction, pcName, configMINIMAL_STACK_SIZE, NULL, uxPriority, &xHelperTask);
+#endif
+}
+
+
+/******************************************************************************
+ * Helper tasks.
+ ******************************************************************************/
+static void prvYieldHelper(void *pvParameters) {
+
+  (void)pvParameters;
+
+  for (;;) {
+    taskYIELD();
+  }
+}
+
+static void prvResumeHelper(void *pvParameters) {
+
+  (void)pvParameters;
+
+  for (;;) {
+    ulStamp = prvCycles();
+    vTaskResume(xBenchTask);
+  }
+}
+
+static void prvNotifyHelper(void *pvParameters) {
+
+  (void)pvParameters;
+
+  for (;;) {
+    ulStamp = prvCycles();
+    xTaskNotifyGive(xBenchTask);
+  }
+}
+
+#if ( configNUMBER_OF_CORES == 1 )
+static void prvIdleMeterHelper(void *pvParameters) {
+
+  uint32_t ulLast = prvCycles(), ulNow;
+
+  (void)pvParameters;
+
+  for (;;) {
+    ulNow = prvCycles();
+    if ((ulNow - ulLast) < benchMETER_GAP) { // longer gaps: preempted by an interrupt or another task
+      ulIdleCycles += ulNow - ulLast;
+    }
+    ulLast = ulNow;
+  }
+}
+#endif
+
+static void prvQueueHelper(void *pvParameters) {
+
+  uint32_t ulValue;
+
+  (void)pvParameters;
+
+  for (;;) {
+    xQueueReceive(xQueueTo, &ulValue, portMAX_DELAY);
+    xQueueSend(xQueueFrom, &ulValue, portMAX_DELAY);
+  }
+}
+
+
+static void prvFrameQueueHelper(void *pvParameters) {
+
+  uint8_t ucReceived[configBENCH_FRAME_SIZE];
+
+  (void)pvParameters;
+
+  for (;;) {
+    xQueueReceive(xFrameQueue, ucReceived, portMAX_DELAY);
+    ulStamp = prvCycles();
+  }
+}
+
+static void prvFrameStreamHelper(void *pvParameters) {
+
+  uint8_t ucReceived[configBENCH_FRAME_SIZE];
+
+  (void)pvParameters;
+
+  for (;;) {
+    xStreamBufferReceive(xFrameStream, ucReceived, configBENCH_FRAME_SIZE, portMAX_DELAY);
+    ulStamp = prvCycles();
+  }
+}
+
+static void prvFrameChannelHelper(void *pvParameters) {
+
+  void *pvFrame;
+
+  (void)pvParameters;
+
+  for (;;) {
+    pvFrame = pvChannelReceive(&xFrameChannel, portMAX_DELAY);
+    ulStamp = prvCycles();
+    vBufPoolFree(&xFramePool, pvFrame);
+  }
+}
+
+static void prvCoroHelper(void *pvParameters) {
+
+  (void)pvParameters;
+
+  vCoroCreate(&xCoroPong, prvCoroPong, NULL);
+  vCoroCreate(&xCoroPing, prvCoroPing, NULL);
+  vCoroRun(); // until both coroutines have finished
+  xTaskNotifyGive(xBenchTask);
+  for (;;) {
+    vTaskSuspend(NULL);
+  }
+}
+
+
+/******************************************************************************
+ * Coroutines of the coro_switch test (the state is kept in static variables).
+ ******************************************************************************/
+static void prvCoroPing(Coro_t *pxCoro) {
+
+  uint32_t ulEvents;
+
+  coroBEGIN(pxCoro);
+  for (ulCoroRounds = 0; ulCoroRounds < configBENCH_ITERATIONS; ulCoroRounds++) {
+    ulStamp = prvCycles();
+    vCoroNotify(&xCoroPong, 1);
+    coroWAIT_EVENTS(pxCoro, 1, portMAX_DELAY, ulEvents);
+    (void)ulEvents;
+  }
+  vCoroNotify(&xCoroPong, 2); // done
+  coroEND(pxCoro);
+}
+
+static void prvCoroPong(Coro_t *pxCoro) {
+
+  uint32_t ulEvents;
+
+  coroBEGIN(pxCoro);
+  for (;;) {
+    coroWAIT_EVENTS(pxCoro, 1 | 2, portMAX_DELAY, ulEvents);
+    if (ulEvents & 2) {
+      break;
+    }
+    prvAdd(&xCoroResult, prvCycles() - ulStamp);
+    vCoroNotify(&xCoroPing, 1);
+  }
+  coroEND(pxCoro);
+}
+
+
+/******************************************************************************
+ * High-resolution timer callback (interrupt context): wake the benchmark task.
+ ******************************************************************************/
+static void prvTimerCallback(void *pvContext) {
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+  ulStamp = prvCycles();
+  ulLateness = (uint32_t)(ullHrTimerGetTime() - ((HrTimer_t *)pvContext)->ullDeadline);
+  vTaskNotifyGiveFromISR(xBenchTask, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+
+#if ( configNUMBER_OF_CORES == 1 )
+/******************************************************************************
+ * Busy-wait for the given number of microseconds.
+ ******************************************************************************/
+static void prvSpin(uint32_t ulUs) {
+
+  uint32_t ulCycles = (uint32_t)ullPlatformMulU32(ulUs, ulPlatformCyclesPerUs);
+  uint32_t ulStart = prvCycles();
+
+  while ((prvCycles() - ulStart) < ulCycles);
+}
+
+
+/******************************************************************************
+ * Software interrupt handler: a slow, low-priority interrupt load.
+ ******************************************************************************/
+static void prvSlowIrqHandler(void *pvContext) {
+
+  (void)pvContext;
+
+  neorv32_clint_msi_clr(0);
+  prvSpin(benchIRQ_LOAD_US);
+}
+
+
+/******************************************************************************
+ * Periodic high-resolution timer callback (interrupt context): record the
+ * latency from the deadline; stop after configBENCH_ITERATIONS * 4 samples.
+ ******************************************************************************/
+static void prvLatencyCallback(void *pvContext) {
+
+  HrTimer_t *pxTimer = (HrTimer_t *)pvContext;
+
+  // the timer has already been re-armed (possibly skipping missed periods): use this expiry's deadline
+  prvAdd(&xIrqLatency, (uint32_t)(ullHrTimerGetTime() - pxTimer->ullExpired));
+  if (++ulIrqSamples >= (configBENCH_ITERATIONS * 4)) {
+    vHrTimerStop(pxTimer);
+  }
+}
+
+
+/******************************************************************************
+ * Interrupt latency test: run a load (called with an increasing round
+ * number) until enough timer samples were taken.
+ ******************************************************************************/
+static void prvIrqLatency(const char *pcName, void (*pxLoad)(uint32_t ulRound)) {
+
+  uint32_t i = 0;
+
+  prvStart(&xIrqLatency);
+  ulIrqSamples = 0;
+  vHrTimerInit(&xTimer, prvLatencyCallback, &xTimer);
+  if (xHrTimerStart(&xTimer, benchIRQ_PERIOD_US, benchIRQ_PERIOD_US) != pdPASS) {
+    return;
+  }
+
+  while (xHrTimerIsActive(&xTimer)) {
+    pxLoad(i++);
+  }
+  prvReport(pcName, &xIrqLatency);
+}
+
+
+/******************************************************************************
+ * Latency test loads: trigger the slow software interrupt handler at varying
+ * offsets to the timer period; send/receive using a kernel queue; the same
+ * using the lock-free MPSC ring.
+ ******************************************************************************/
+static void prvMsiLoad(uint32_t ulRound) {
+
+  neorv32_clint_msi_set(0);
+  prvSpin(benchIRQ_LOAD_US + (ulRound % 7) * 3);
+}
+
+static void prvQueueLoad(uint32_t ulRound) {
+
+  uint32_t ulValue;
+
+  xQueueSend(xQueueTo, &ulRound, 0);
+  xQueueReceive(xQueueTo, &ulValue, 0);
+}
+
+static void prvLockFreeLoad(uint32_t ulRound) {
+
+  (void)ulRound;
+
+  xMpscRingPush(&xMpscRing, (void *)&ulCounter);
+  pvMpscRingPop(&xMpscRing);
+}
+#endif
+
+
+#if ( configNUMBER_OF_CORES == 1 )
+/******************************************************************************
+ * Console output test: send the test line benchUART_ROUNDS times using the
+ * TX interrupt or the DMA and wait until it has been sent. The idle meter
+ * task runs at the lowest priority meanwhile (single-core only, otherwise it
+ * would just run on the other core).
+ ******************************************************************************/
+static void prvUartOutput(const char *pcName, BaseType_t xUseDma) {
+
+  BenchResult_t xResult;
+  uint32_t ulStart, ulCycles, ulTotal = 0, ulIdle = 0, i;
+
+  if (prvCreateHelper(prvIdleMeterHelper, "Meter", benchLOW_PRIORITY) != pdPASS) {
+    return;
+  }
+
+  prvStart(&xResult);
+  for (i = 0; i < benchUART_ROUNDS; i++) {
+    xConsoleWriteDma(cUartLine, 0); // wait until the previous output has been sent
+    ulIdleCycles = 0;
+    ulStart = prvCycles();
+    if (xUseDma != pdFALSE) {
+      xConsoleWriteDma(cUartLine, sizeof(cUartLine));
+    }
+    else {
+      xConsoleWrite(cUartLine, sizeof(cUartLine), portMAX_DELAY);
+      xConsoleWriteDma(cUartLine, 0);
+    }
+    ulCycles = prvCycles() - ulStart;
+    ulIdle += ulIdleCycles;
+    ulTotal += ulCycles;
+    prvAdd(&xResult, ulCycles);
+  }
+  vTaskDelete(xHelperTask);
+
+  prvReport(pcName, &xResult);
+  vConsolePrintfBlocking("#BENCH-UTIL:%s busy=%u%%\n", pcName, (unsigned)(100 - ulIdle / ((ulTotal / 100) + 1)));
+}
+#endif
+
+
+/******************************************************************************
+ * Benchmark task: run all tests and print the results.
+ ******************************************************************************/
+static void prvBenchTask(void *pvParameters) {
+
+  BenchResult_t xResult, xLateness;
+  DmaTransfer_t xTransfer;
+  SemaphoreHandle_t xSemaphore;
+  uint32_t ulStart, ulValue, i;
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+  void *pvBlock;
+#endif
+
+  (void)pvParameters;
+
+  vConsolePrintfBlocking("\nRunning kernel benchmarks (%u iterations, cycles: min avg max)...\n",
+                         (unsigned)configBENCH_ITERATIONS);
+  vConsolePrintfBlocking("#BENCH-CFG:icache=%u dcache=%u line=%u priorities=%u zbb=%u atomics=%u\n",
+                         (unsigned)((NEORV32_SYSINFO->SOC >> SYSINFO_SOC_ICACHE) & 1),
+                         (unsigned)((NEORV32_SYSINFO->SOC >> SYSINFO_SOC_DCACHE) & 1), (unsigned)ulCacheGetDataLineSize(),
+                         (unsigned)configMAX_PRIORITIES, (unsigned)((ulPlatformIsa & platformISA_ZBB) != 0),
+                         (unsigned)lockfreeHAS_ATOMICS);
+
+  // calibration: cost of reading the cycle counter
+  ulOverhead = 0xffffffffu;
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    ulStart = prvCycles();
+    ulValue = prvCycles() - ulStart;
+    if (ulValue < ulOverhead) {
+      ulOverhead = ulValue;
+    }
+  }
+
+  // context switch via taskYIELD() between two tasks of equal priority (two switches per iteration)
+  if (prvCreateHelper(prvYieldHelper, "Yield", benchPRIORITY) == pdPASS) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      ulStart = prvCycles();
+      taskYIELD();
+      prvAdd(&xResult, (prvCycles() - ulStart) / 2);
+    }
+    vTaskDelete(xHelperTask); // deleting another task releases its memory right away
+    prvReport("ctx_yield", &xResult);
+  }
+
+  // preemption: a low-priority task resumes this (higher-priority) task
+  if (prvCreateHelper(prvResumeHelper, "Resume", benchLOW_PRIORITY) == pdPASS) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      vTaskSuspend(NULL);
+      prvAdd(&xResult, prvCycles() - ulStamp);
+    }
+    vTaskDelete(xHelperTask);
+    prvReport("ctx_preempt", &xResult);
+  }
+
+#if ( configNUMBER_OF_CORES == 1 )
+  // scheduler: taskYIELD() while no other task is ready at this or a higher priority, so the kernel
+  // selects this task again; trap entry/exit, ready-list lookup and the per-switch hooks
+  prvStart(&xResult);
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    ulStart = prvCycles();
+    taskYIELD();
+    prvAdd(&xResult, prvCycles() - ulStart);
+  }
+  prvReport("ctx_select", &xResult);
+#endif
+
+  // queue round trip through a higher-priority task
+  if (prvCreateHelper(prvQueueHelper, "Queue", benchHIGH_PRIORITY) == pdPASS) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      ulStart = prvCycles();
+      xQueueSend(xQueueTo, &i, portMAX_DELAY);
+      xQueueReceive(xQueueFrom, &ulValue, portMAX_DELAY);
+      prvAdd(&xResult, prvCycles() - ulStart);
+    }
+    vTaskDelete(xHelperTask);
+    prvReport("queue_roundtrip", &xResult);
+  }
+
+  // binary semaphore give + take (no contention)
+  xSemaphore = benchBINARY_CREATE();
+  if (xSemaphore != NULL) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      ulStart = prvCycles();
+      xSemaphoreGive(xSemaphore);
+      xSemaphoreTake(xSemaphore, 0);
+      prvAdd(&xResult, prvCycles() - ulStart);
+    }
+    vSemaphoreDelete(xSemaphore);
+    prvReport("sem_give_take", &xResult);
+  }
+
+  // mutex take + give (no contention)
+  xSemaphore = benchMUTEX_CREATE();
+  if (xSemaphore != NULL) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      ulStart = prvCycles();
+      xSemaphoreTake(xSemaphore, 0);
+      xSemaphoreGive(xSemaphore);
+      prvAdd(&xResult, prvCycles() - ulStart);
+    }
+    vSemaphoreDelete(xSemaphore);
+    prvReport("mutex_take_give", &xResult);
+  }
+
+  // task notification give + take on the own task (no context switch)
+  prvStart(&xResult);
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    ulStart = prvCycles();
+    xTaskNotifyGive(xBenchTask);
+    ulTaskNotifyTake(pdTRUE, 0);
+    prvAdd(&xResult, prvCycles() - ulStart);
+  }
+  prvReport("notify_give_take", &xResult);
+
+  // task notification from a low-priority task waking up this task
+  if (prvCreateHelper(prvNotifyHelper, "Notify", benchLOW_PRIORITY) == pdPASS) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      prvAdd(&xResult, prvCycles() - ulStamp);
+    }
+    vTaskDelete(xHelperTask);
+    prvReport("notify_wake", &xResult);
+  }
+
+  // the same between two stackless coroutines in one executor task
+  prvStart(&xCoroResult);
+  if (prvCreateHelper(prvCoroHelper, "Coro", benchLOW_PRIORITY) == pdPASS) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    vTaskDelete(xHelperTask);
+    prvReport("coro_switch", &xCoroResult);
+    vConsolePrintfBlocking("#BENCH-MEM:coro=%u task=%u\n", (unsigned)sizeof(Coro_t),
+                           (unsigned)(sizeof(StaticTask_t) + (configMINIMAL_STACK_SIZE * sizeof(StackType_t))));
+  }
+
+  // frame hand-over to a higher-priority consumer: copying queue
+  xFrameQueue = benchFRAME_QUEUE_CREATE();
+  if ((xFrameQueue != NULL) && (prvCreateHelper(prvFrameQueueHelper, "FrameQ", benchHIGH_PRIORITY) == pdPASS)) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      ulStart = prvCycles();
+      xQueueSend(xFrameQueue, ucFrame, portMAX_DELAY);
+      prvAdd(&xResult, ulStamp - ulStart);
+    }
+    vTaskDelete(xHelperTask);
+    prvReport("frame_queue", &xResult);
+  }
+  if (xFrameQueue != NULL) {
+    vQueueDelete(xFrameQueue);
+  }
+
+  // frame hand-over: copying stream buffer
+  xFrameStream = benchFRAME_STREAM_CREATE();
+  if ((xFrameStream != NULL) && (prvCreateHelper(prvFrameStreamHelper, "FrameS", benchHIGH_PRIORITY) == pdPASS)) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      ulStart = prvCycles();
+      xStreamBufferSend(xFrameStream, ucFrame, configBENCH_FRAME_SIZE, portMAX_DELAY);
+      prvAdd(&xResult, ulStamp - ulStart);
+    }
+    vTaskDelete(xHelperTask);
+    prvReport("frame_stream", &xResult);
+  }
+  if (xFrameStream != NULL) {
+    vStreamBufferDelete(xFrameStream);
+  }
+
+  // frame hand-over: zero-copy channel (including pool allocation)
+  vBufPoolInit(&xFramePool, ulFramePoolStorage, configBENCH_FRAME_SIZE, 2);
+  vChannelInit(&xFrameChannel, pvFrameSlots, 2);
+  if (prvCreateHelper(prvFrameChannelHelper, "FrameC", benchHIGH_PRIORITY) == pdPASS) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      ulStart = prvCycles();
+      xChannelSend(&xFrameChannel, pvBufPoolAlloc(&xFramePool));
+      prvAdd(&xResult, ulStamp - ulStart);
+    }
+    vTaskDelete(xHelperTask);
+    prvReport("frame_channel", &xResult);
+  }
+
+  // ISR-to-task wakeup latency: timer callback entry -> task running;
+  // high-resolution timer latency: deadline -> callback entry (MTIME cycles)
+  vHrTimerInit(&xTimer, prvTimerCallback, &xTimer);
+  if (xHrTimerStart(&xTimer, benchHRTIMER_DELAY_US, 0) == pdPASS) {
+    prvStart(&xResult);
+    prvStart(&xLateness);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      if (i != 0) {
+        xHrTimerStart(&xTimer, benchHRTIMER_DELAY_US, 0);
+      }
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      prvAdd(&xResult, prvCycles() - ulStamp);
+      prvAdd(&xLateness, ulLateness);
+    }
+    prvReport("isr_wake", &xResult);
+    prvReport("hrtimer_late", &xLateness);
+  }
+
+#if ( configNUMBER_OF_CORES == 1 )
+  // worst-case timer interrupt latency under a slow interrupt load: same priority (the timer
+  // waits for the slow handler) vs. higher priority (the timer preempts it)
+  if (xNeorv32IrqAttach(neorv32IRQ_CHANNEL_MSI, prvSlowIrqHandler, NULL) == pdPASS) {
+    prvIrqLatency("irq_lat_flat", prvMsiLoad);
+#if ( configUSE_IRQ_NESTING == 1 )
+    vNeorv32IrqSetPriority(neorv32IRQ_CHANNEL(GPTMR_TRAP_CODE), 1);
+    prvIrqLatency("irq_lat_nested", prvMsiLoad);
+    vNeorv32IrqSetPriority(neorv32IRQ_CHANNEL(GPTMR_TRAP_CODE), 0);
+#endif
+    vNeorv32IrqDetach(neorv32IRQ_CHANNEL_MSI);
+  }
+#endif
+
+  // shared counter: kernel critical section vs. atomic add
+  prvStart(&xResult);
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    ulStart = prvCycles();
+    taskENTER_CRITICAL();
+    ulCounter++;
+    taskEXIT_CRITICAL();
+    prvAdd(&xResult, prvCycles() - ulStart);
+  }
+  prvReport("atomic_critical", &xResult);
+
+  prvStart(&xResult);
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    ulStart = prvCycles();
+    ulAtomicFetchAdd(&ulCounter, 1);
+    prvAdd(&xResult, prvCycles() - ulStart);
+  }
+  prvReport("atomic_add", &xResult);
+
+  // lock-free rings: push + pop
+  vSpscRingInit(&xSpscRing, ulSpscSlots, 4);
+  prvStart(&xResult);
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    ulStart = prvCycles();
+    xSpscRingPush(&xSpscRing, i);
+    xSpscRingPop(&xSpscRing, &ulValue);
+    prvAdd(&xResult, prvCycles() - ulStart);
+  }
+  prvReport("ring_spsc", &xResult);
+
+  vMpscRingInit(&xMpscRing, pvMpscSlots, 4);
+  prvStart(&xResult);
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    ulStart = prvCycles();
+    xMpscRingPush(&xMpscRing, (void *)&ulCounter);
+    pvMpscRingPop(&xMpscRing);
+    prvAdd(&xResult, prvCycles() - ulStart);
+  }
+  prvReport("ring_mpsc", &xResult);
+
+#if ( configNUMBER_OF_CORES == 1 )
+  // timer interrupt latency while the task passes data through a kernel queue vs. the MPSC ring
+  prvIrqLatency("irq_lat_queue", prvQueueLoad);
+  prvIrqLatency("irq_lat_lockfree", prvLockFreeLoad);
+#endif
+
+  // memory copy: CPU (polled) vs. DMA (blocking on the completion interrupt)
+  prvStart(&xResult);
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    ulStart = prvCycles();
+    memcpy(ulCopyDestination, ulCopySource, configBENCH_COPY_SIZE);
+    prvAdd(&xResult, prvCycles() - ulStart);
+  }
+  prvReport("copy_cpu", &xResult);
+
+  if (xDmaMemcpy(ulCopyDestination, ulCopySource, configBENCH_COPY_SIZE) == pdPASS) {
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      ulStart = prvCycles();
+      xDmaMemcpy(ulCopyDestination, ulCopySource, configBENCH_COPY_SIZE);
+      prvAdd(&xResult, prvCycles() - ulStart);
+    }
+    prvReport("copy_dma", &xResult);
+
+    prvStart(&xResult);
+    for (i = 0; i < configBENCH_ITERATIONS; i++) {
+      vDmaPrepare(&xTransfer, ulCopySource, ulCopyDestination, configBENCH_COPY_SIZE / sizeof(uint32_t),
+                  DMA_CMD_W2W | DMA_CMD_SRC_INC | DMA_CMD_DST_INC);
+      ulStart = prvCycles();
+      xDmaSubmit(&xTransfer);
+      prvAdd(&xResult, prvCycles() - ulStart);
+      xDmaWait(&xTransfer, portMAX_DELAY);
+    }
+    prvReport("dma_submit", &xResult);
+
+#if ( configNUMBER_OF_CORES == 1 )
+    // console output: TX interrupt vs. DMA, CPU time left for other tasks
+    memset(cUartLine, '-', sizeof(cUartLine));
+    memcpy(cUartLine, "#BENCH-TX:", 10);
+    cUartLine[sizeof(cUartLine) - 2] = '\r';
+    cUartLine[sizeof(cUartLine) - 1] = '\n';
+    prvUartOutput("uart_irq", pdFALSE);
+    prvUartOutput("uart_dma", pdTRUE);
+#endif
+  }
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+  // heap allocation / free
+  prvStart(&xResult);
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    ulStart = prvCycles();
+    pvBlock = pvPortMalloc(32);
+    prvAdd(&xResult, prvCycles() - ulStart);
+    vPortFree(pvBlock);
+  }
+  prvReport("malloc", &xResult);
+
+  prvStart(&xResult);
+  for (i = 0; i < configBENCH_ITERATIONS; i++) {
+    pvBlock = pvPortMalloc(32);
+    ulStart = prvCycles();
+    vPortFree(pvBlock);
+    prvAdd(&xResult, prvCycles() - ulStart);
+  }
+  prvReport("free", &xResult);
+#endif
+
+  vConsolePrintfBlocking("#BENCH-END\n");
+
+  for (;;) {
+    vTaskSuspend(NULL);
+  }
+}
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Deferred binary logging
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Binary logging and console */
+#include "binlog.h"
+#include "console.h"
+
+#if ( configUSE_BINLOG == 1 )
+
+#if ((configBINLOG_ISR_RING_WORDS & (configBINLOG_ISR_RING_WORDS - 1)) != 0) || \
+    ((configBINLOG_TASK_RING_WORDS & (configBINLOG_TASK_RING_WORDS - 1)) != 0)
+  #error "configBINLOG_ISR_RING_WORDS and configBINLOG_TASK_RING_WORDS have to be a power of two!"
+#endif
+
+/* Ring buffers */
+static uint32_t ulIsrRingBuffer[configBINLOG_ISR_RING_WORDS];
+static uint32_t ulTaskRingBuffer[configBINLOG_TASK_RING_WORDS];
+
+BinlogRing_t xBinlogIsrRing  = { ulIsrRingBuffer,  configBINLOG_ISR_RING_WORDS - 1,  0, 0, 0 };
+BinlogRing_t xBinlogTaskRing = { ulTaskRingBuffer, configBINLOG_TASK_RING_WORDS - 1, 0, 0, 0 };
+
+/* Prototypes */
+static void prvBinlogTask(void *pvParameters);
+static char *prvHex(char *pcBuffer, uint32_t ulValue);
+static void prvDrain(BinlogRing_t *pxRing);
+
+
+/******************************************************************************
+ * Create the log task.
+ ******************************************************************************/
+void vBinlogInit(void) {
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  static StaticTask_t xBinlogTCB configSTATIC_DATA;
+  static StackType_t xBinlogStack[configMINIMAL_STACK_SIZE] configSTATIC_DATA;
+  xTaskCreateStatic(prvBinlogTask, "Log", configMINIMAL_STACK_SIZE, NULL, configBINLOG_TASK_PRIORITY, xBinlogStack, &xBinlogTCB);
+#else
+  xTaskCreate(prvBinlogTask, "Log", configMINIMAL_STACK_SIZE, NULL, configBINLOG_TASK_PRIORITY, NULL);
+#endif
+}
+
+
+/******************************************************************************
+ * Write a word as 8 hex characters followed by a space.
+ ******************************************************************************/
+static char *prvHex(char *pcBuffer, uint32_t ulValue) {
+
+  static const char cDigits[] = "0123456789abcdef";
+  int i;
+
+  for (i = 28; i >= 0; i -= 4) {
+    *pcBuffer++ = cDigits[(ulValue >> i) & 0xf];
+  }
+  *pcBuffer++ = ' ';
+  return pcBuffer;
+}
+
+
+/******************************************************************************
+ * Send all records of a ring as "#BL:" lines.
+ ******************************************************************************/
+static void prvDrain(BinlogRing_t *pxRing) {
+
+  char cLine[4 + (5 * 9) + 2];
+  char *pcPos;
+  uint32_t ulTail, ulWords;
+
+  while ((ulTail = pxRing->ulTail) != pxRing->ulHead) {
+    ulWords = 2 + (pxRing->pulBuffer[ulTail & pxRing->ulMask] & 3);
+
+    pcPos = cLine;
+    *pcPos++ = '#';
+    *pcPos++ = 'B';
+    *pcPos++ = 'L';
+    *pcPos++ = ':';
+    while (ulWords--) {
+      pcPos = prvHex(pcPos, pxRing->pulBuffer[ulTail++ & pxRing->ulMask]);
+    }
+    pcPos[-1] = '\r';
+    *pcPos++ = '\n';
+
+    pxRing->ulTail = ulTail; // release the record before (potentially) blocking on the console
+    xConsoleWrite(cLine, (size_t)(pcPos - cLine), portMAX_DELAY);
+  }
+}
+
+
+/******************************************************************************
+ * Log task: periodically drain both rings.
+ ******************************************************************************/
+static void prvBinlogTask(void *pvParameters) {
+
+  uint32_t ulIsrDropped = 0, ulTaskDropped = 0;
+  char cLine[5 + (2 * 9) + 1];
+  char *pcPos;
+
+  (void)pvParameters;
+
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(configBINLOG_FLUSH_PERIOD_MS));
+
+    prvDrain(&xBinlogIsrRing);
+    prvDrain(&xBinlogTaskRing);
+
+    // report lost records
+    if ((xBinlogIsrRing.ulDropped != ulIsrDropped) || (xBinlogTaskRing.ulDropped != ulTaskDropped)) {
+      ulIsrDropped = xBinlogIsrRing.ulDropped;
+      ulTaskDropped = xBinlogTaskRing.ulDropped;
+      pcPos = cLine;
+      *pcPos++ = '#';
+      *pcPos++ = 'B';
+      *pcPos++ = 'L';
+      *pcPos++ = 'D';
+      *pcPos++ = ':';
+      pcPos = prvHex(pcPos, ulIsrDropped);
+      pcPos = prvHex(pcPos, ulTaskDropped);
+      pcPos[-1] = '\r';
+      *pcPos++ = '\n';
+      xConsoleWrite(cLine, (size_t)(pcPos - cLine), portMAX_DELAY);
+    }
+  }
+}
+
+#endif /* configUSE_BINLOG */
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Deferred binary logging
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Instead of formatting text, BINLOG() / BINLOG_ISR() only store a compact
+ * binary record into a RAM ring buffer:
+ *
+ *   word 0: address of the format string | number of arguments (0..3)
+ *   word 1: MTIME timestamp (low word)
+ *   word 2..4: arguments (32-bit each)
+ *
+ * The format string itself is never touched on the target. A low-priority
+ * log task drains the rings and sends each record as one "#BL:" text line via
+ * the console. tools/binlog_decode.py turns these lines back into text using
+ * the format strings stored in main.elf.
+ *
+ * There is one ring per context: BINLOG_ISR() may only be used in interrupt
+ * handlers (which do not nest by default, so the ISR ring has a single
+ * producer and needs no locking at all; with configUSE_IRQ_NESTING the
+ * record is written with interrupts masked), BINLOG() may only be used by
+ * tasks (the record is written with interrupts masked for a few
+ * instructions).
+ *
+ * Arguments are stored as 32-bit words; "%s" arguments are resolved by the
+ * decoder and hence have to point to constant strings stored in main.elf.
+ ******************************************************************************/
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+
+#include "irq_mask.h"
+
+#if ( configUSE_BINLOG == 1 )
+
+/* Ring buffer state */
+typedef struct {
+  uint32_t *pulBuffer;         // word buffer, size is a power of two
+  uint32_t ulMask;             // buffer size - 1
+  volatile uint32_t ulHead;    // producer index (free-running)
+  volatile uint32_t ulTail;    // consumer index (free-running)
+  volatile uint32_t ulDropped; // number of records dropped because the ring was full
+} BinlogRing_t;
+
+extern BinlogRing_t xBinlogIsrRing;
+extern BinlogRing_t xBinlogTaskRing;
+
+void vBinlogInit(void);
+
+/* Argument counting and padding helpers (0 to 3 arguments) */
+#define prvBINLOG_NARGS_(_0, _1, _2, _3, N, ...) N
+#define binlogNARGS(...) prvBINLOG_NARGS_(0, ##__VA_ARGS__, 3, 2, 1, 0)
+#define prvBINLOG_ARGS_(_0, a, b, c, ...) (uint32_t)(a), (uint32_t)(b), (uint32_t)(c)
+#define binlogARGS(...) prvBINLOG_ARGS_(0, ##__VA_ARGS__, 0, 0, 0, 0)
+
+/* The format string is aligned so the lowest two address bits can hold the argument count */
+#define prvBINLOG(xWrite, pcFormat, ...) do { \
+  static const char binlogFORMAT[] __attribute__((aligned(4))) = pcFormat; \
+  xWrite((uint32_t)binlogFORMAT | binlogNARGS(__VA_ARGS__), binlogARGS(__VA_ARGS__)); \
+} while (0)
+
+#define BINLOG(pcFormat, ...)     prvBINLOG(vBinlogWrite, pcFormat, ##__VA_ARGS__)
+#define BINLOG_ISR(pcFormat, ...) prvBINLOG(vBinlogWriteFromISR, pcFormat, ##__VA_ARGS__)
+
+
+/******************************************************************************
+ * Append a record to a ring. There must be only one producer at a time.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vBinlogPush(BinlogRing_t *pxRing, uint32_t ulHeader,
+                                                              uint32_t ulArg0, uint32_t ulArg1, uint32_t ulArg2) {
+
+  uint32_t ulArgs = ulHeader & 3;
+  uint32_t ulHead = pxRing->ulHead;
+  uint32_t ulMask = pxRing->ulMask;
+  uint32_t *pulBuffer = pxRing->pulBuffer;
+
+  if (((ulMask + 1) - (ulHead - pxRing->ulTail)) < (2 + ulArgs)) {
+    pxRing->ulDropped++;
+    return;
+  }
+
+  pulBuffer[ulHead++ & ulMask] = ulHeader;
+  pulBuffer[ulHead++ & ulMask] = *(volatile uint32_t *)(configMTIME_BASE_ADDRESS);
+  if (ulArgs > 0) {
+    pulBuffer[ulHead++ & ulMask] = ulArg0;
+  }
+  if (ulArgs > 1) {
+    pulBuffer[ulHead++ & ulMask] = ulArg1;
+  }
+  if (ulArgs > 2) {
+    pulBuffer[ulHead++ & ulMask] = ulArg2;
+  }
+
+  __asm volatile ("" : : : "memory"); // record data has to be written before it is published
+  pxRing->ulHead = ulHead;
+}
+
+
+/******************************************************************************
+ * Log from an interrupt handler.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vBinlogWriteFromISR(uint32_t ulHeader, uint32_t ulArg0,
+                                                                      uint32_t ulArg1, uint32_t ulArg2) {
+
+#if ( configUSE_IRQ_NESTING == 1 )
+  uint32_t ulStatus = ulIrqMaskSave();
+
+  vBinlogPush(&xBinlogIsrRing, ulHeader, ulArg0, ulArg1, ulArg2);
+  vIrqMaskRestore(ulStatus);
+#else
+  vBinlogPush(&xBinlogIsrRing, ulHeader, ulArg0, ulArg1, ulArg2);
+#endif
+}
+
+
+/******************************************************************************
+ * Log from a task.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vBinlogWrite(uint32_t ulHeader, uint32_t ulArg0,
+                                                               uint32_t ulArg1, uint32_t ulArg2) {
+
+  uint32_t ulStatus = ulIrqMaskSave();
+
+  vBinlogPush(&xBinlogTaskRing, ulHeader, ulArg0, ulArg1, ulArg2);
+  vIrqMaskRestore(ulStatus);
+}
+
+#else
+
+/* Logging disabled: fall back to (non-blocking) formatted console output */
+#include "console.h"
+
+#define vBinlogInit()
+#define BINLOG(pcFormat, ...)     vConsolePrintf(pcFormat "\n", ##__VA_ARGS__)
+#define BINLOG_ISR(pcFormat, ...) vConsolePrintf(pcFormat "\n", ##__VA_ARGS__)
+
+#endif /* configUSE_BINLOG */
+
+#endif /* BINLOG_H */
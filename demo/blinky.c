@@ -105,17 +105,37 @@ static void prvQueueSendTask( void *pvParameters );
 /* The queue used by both tasks. */
 static QueueHandle_t xQueue = NULL;
 
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+/* Memory for the queue and the tasks if they are created statically. */
+static StaticQueue_t xQueueBuffer configSTATIC_DATA;
+static uint8_t ucQueueStorage[ mainQUEUE_LENGTH * sizeof( unsigned long ) ] configSTATIC_DATA;
+static StaticTask_t xReceiveTaskTCB configSTATIC_DATA;
+static StackType_t xReceiveTaskStack[ configMINIMAL_STACK_SIZE ] configSTATIC_DATA;
+static StaticTask_t xSendTaskTCB configSTATIC_DATA;
+static StackType_t xSendTaskStack[ configMINIMAL_STACK_SIZE ] configSTATIC_DATA;
+
+#endif
+
 /*-----------------------------------------------------------*/
 
 void blinky( void ) {
 
     /* Create the queue. */
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    xQueue = xQueueCreateStatic( mainQUEUE_LENGTH, sizeof( unsigned long ), ucQueueStorage, &xQueueBuffer );
+    #else
     xQueue = xQueueCreate( mainQUEUE_LENGTH, sizeof( unsigned long ) );
+    #endif
 
     if( xQueue != NULL )
     {
         /* Start the two tasks as described in the comments at the top of this
          * file. */
+        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+        xTaskCreateStatic( prvQueueReceiveTask, "Rx", configMINIMAL_STACK_SIZE, NULL, mainQUEUE_RECEIVE_TASK_PRIORITY, xReceiveTaskStack, &xReceiveTaskTCB );
+        xTaskCreateStatic( prvQueueSendTask, "TX", configMINIMAL_STACK_SIZE, NULL, mainQUEUE_SEND_TASK_PRIORITY, xSendTaskStack, &xSendTaskTCB );
+        #else
         xTaskCreate( prvQueueReceiveTask,               /* The function that implements the task. */
                     "Rx",                               /* The text name assigned to the task - for debug only as it is not used by the kernel. */
                     configMINIMAL_STACK_SIZE,           /* The size of the stack to allocate to the task. */
@@ -124,6 +144,7 @@ void blinky( void ) {
                     NULL );                             /* The task handle is not required, so NULL is passed. */
 
         xTaskCreate( prvQueueSendTask, "TX", configMINIMAL_STACK_SIZE, NULL, mainQUEUE_SEND_TASK_PRIORITY, NULL );
+        #endif
 
         /* Start the tasks and timer running. */
         vTaskStartScheduler();
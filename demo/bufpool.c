@@ -0,0 +1,192 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Fixed-block buffer pool and zero-copy channels
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Buffer pool and channels */
+#include "bufpool.h"
+#include "irq_mask.h"
+
+
+//#################################################################################################
+// Buffer Pool
+//#################################################################################################
+
+/******************************************************************************
+ * Initialize a pool of ulBlocks blocks of xBlockSize bytes using pvStorage
+ * (see bufpoolSTORAGE()).
+ ******************************************************************************/
+void vBufPoolInit(BufPool_t *pxPool, void *pvStorage, size_t xBlockSize, uint32_t ulBlocks) {
+
+  uint8_t *pucBlock = (uint8_t *)pvStorage;
+  uint32_t i;
+
+  xBlockSize = bufpoolBLOCK_SIZE(xBlockSize);
+  configASSERT((((uint32_t)pvStorage & 7u) == 0) && (ulBlocks != 0));
+
+  // link all blocks into the free list
+  for (i = 0; i < ulBlocks - 1; i++) {
+    *(void **)pucBlock = pucBlock + xBlockSize;
+    pucBlock += xBlockSize;
+  }
+  *(void **)pucBlock = NULL;
+
+  pxPool->pvFreeList = pvStorage;
+  pxPool->pucStart = (uint8_t *)pvStorage;
+  pxPool->pucEnd = (uint8_t *)pvStorage + (ulBlocks * xBlockSize);
+  pxPool->xBlockSize = xBlockSize;
+  pxPool->ulFree = ulBlocks;
+  pxPool->ulMinFree = ulBlocks;
+}
+
+
+/******************************************************************************
+ * Get a block from the pool. Returns NULL if the pool is exhausted.
+ ******************************************************************************/
+configFAST_TEXT void *pvBufPoolAlloc(BufPool_t *pxPool) {
+
+  uint32_t ulStatus = ulIrqMaskSave();
+  void *pvBlock = pxPool->pvFreeList;
+
+  if (pvBlock != NULL) {
+    pxPool->pvFreeList = *(void **)pvBlock;
+    pxPool->ulFree--;
+    if (pxPool->ulFree < pxPool->ulMinFree) {
+      pxPool->ulMinFree = pxPool->ulFree;
+    }
+  }
+
+  vIrqMaskRestore(ulStatus);
+  return pvBlock;
+}
+
+
+/******************************************************************************
+ * Return a block to the pool.
+ ******************************************************************************/
+configFAST_TEXT void vBufPoolFree(BufPool_t *pxPool, void *pvBlock) {
+
+  uint32_t ulStatus;
+
+  configASSERT(((uint8_t *)pvBlock >= pxPool->pucStart) && ((uint8_t *)pvBlock < pxPool->pucEnd) &&
+               ((((uint8_t *)pvBlock - pxPool->pucStart) % pxPool->xBlockSize) == 0));
+
+  ulStatus = ulIrqMaskSave();
+  *(void **)pvBlock = pxPool->pvFreeList;
+  pxPool->pvFreeList = pvBlock;
+  pxPool->ulFree++;
+  vIrqMaskRestore(ulStatus);
+}
+
+
+/******************************************************************************
+ * Get the current / the lowest ever number of free blocks.
+ ******************************************************************************/
+uint32_t ulBufPoolGetFree(const BufPool_t *pxPool) {
+
+  return pxPool->ulFree;
+}
+
+uint32_t ulBufPoolGetMinFree(const BufPool_t *pxPool) {
+
+  return pxPool->ulMinFree;
+}
+
+
+//#################################################################################################
+// Zero-Copy Channel
+//#################################################################################################
+
+/******************************************************************************
+ * Initialize a channel using a ring of ulSlots pointers (power of two).
+ ******************************************************************************/
+void vChannelInit(Channel_t *pxChannel, void **ppvSlots, uint32_t ulSlots) {
+
+  vMpscRingInit(&pxChannel->xRing, ppvSlots, ulSlots);
+  pxChannel->xReceiver = NULL;
+}
+
+
+/******************************************************************************
+ * Pass a buffer to the receiver (task context). Does not block; returns
+ * pdFAIL if the channel is full (the caller keeps the ownership then).
+ ******************************************************************************/
+configFAST_TEXT BaseType_t xChannelSend(Channel_t *pxChannel, void *pvBuffer) {
+
+  TaskHandle_t xReceiver;
+
+  if (xMpscRingPush(&pxChannel->xRing, pvBuffer) != pdPASS) {
+    return pdFAIL;
+  }
+  lockfreeFENCE(); // publish before looking for the receiver
+  xReceiver = pxChannel->xReceiver;
+  if (xReceiver != NULL) {
+    xTaskNotifyGiveIndexed(xReceiver, configCHANNEL_NOTIFY_INDEX);
+  }
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Pass a buffer to the receiver (interrupt context).
+ ******************************************************************************/
+configFAST_TEXT BaseType_t xChannelSendFromISR(Channel_t *pxChannel, void *pvBuffer, BaseType_t *pxHigherPriorityTaskWoken) {
+
+  TaskHandle_t xReceiver;
+
+  if (xMpscRingPush(&pxChannel->xRing, pvBuffer) != pdPASS) {
+    return pdFAIL;
+  }
+  lockfreeFENCE(); // publish before looking for the receiver
+  xReceiver = pxChannel->xReceiver;
+  if (xReceiver != NULL) {
+    vTaskNotifyGiveIndexedFromISR(xReceiver, configCHANNEL_NOTIFY_INDEX, pxHigherPriorityTaskWoken);
+  }
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Get the next buffer (the caller becomes its owner). Blocks for up to
+ * xTicksToWait; returns NULL on timeout. Only a single task may receive from
+ * a channel. The receiver registers before it checks the ring, so a sender
+ * either finds the registration or its buffer is found by the check.
+ ******************************************************************************/
+configFAST_TEXT void *pvChannelReceive(Channel_t *pxChannel, TickType_t xTicksToWait) {
+
+  void *pvBuffer;
+  TimeOut_t xTimeOut;
+
+  vTaskSetTimeOutState(&xTimeOut);
+  pxChannel->xReceiver = xTaskGetCurrentTaskHandle();
+  lockfreeFENCE();
+
+  while (((pvBuffer = pvMpscRingPop(&pxChannel->xRing)) == NULL) &&
+         (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE)) {
+    ulTaskNotifyTakeIndexed(configCHANNEL_NOTIFY_INDEX, pdTRUE, xTicksToWait);
+  }
+
+  pxChannel->xReceiver = NULL;
+  return pvBuffer;
+}
+
+
+/******************************************************************************
+ * Get the number of buffers waiting in the channel.
+ ******************************************************************************/
+uint32_t ulChannelGetCount(const Channel_t *pxChannel) {
+
+  return ulMpscRingCount(&pxChannel->xRing);
+}
@@ -0,0 +1,77 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Fixed-block buffer pool and zero-copy channels
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * A buffer pool manages a static array of equally sized blocks using a free
+ * list. Allocating and freeing a block takes constant time (a few
+ * instructions with interrupts masked), never fragments and is safe to be
+ * used from tasks and from interrupt handlers.
+ *
+ * A channel passes pointers (usually pool blocks) from any number of
+ * producers (tasks or interrupt handlers) to a single receiving task. Only
+ * the pointer is put into the channel's ring buffer, so sending a frame does
+ * not copy its content: ownership of the buffer is passed to the receiver,
+ * which eventually returns it to the pool. The receiver blocks using a
+ * direct-to-task notification (configCHANNEL_NOTIFY_INDEX). The ring is a
+ * lock-free MPSC ring (lockfree.h), so sending does not disable interrupts
+ * if the A extension is available.
+ *
+ * Typical pipeline stage:
+ *
+ *   pxFrame = pvChannelReceive(&xInput, portMAX_DELAY);
+ *   ... process frame in place ...
+ *   if (xChannelSend(&xOutput, pxFrame) != pdPASS) {
+ *     vBufPoolFree(&xFramePool, pxFrame); // output full: drop frame
+ *   }
+ ******************************************************************************/
+
+#ifndef BUFPOOL_H
+#define BUFPOOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Lock-free MPSC ring */
+#include "lockfree.h"
+
+/* Block sizes are rounded up to a multiple of 8 bytes */
+#define bufpoolBLOCK_SIZE( xSize )           ( ( ( size_t )( xSize ) + 7u ) & ~( size_t )7u )
+
+/* Define (static) storage for ulBlocks blocks of xSize bytes each */
+#define bufpoolSTORAGE( name, xSize, ulBlocks ) \
+  uint64_t name[ ( bufpoolBLOCK_SIZE( xSize ) * ( ulBlocks ) ) / sizeof( uint64_t ) ]
+
+/* Buffer pool */
+typedef struct {
+  void *pvFreeList;      // first free block; each free block holds the address of the next one
+  uint8_t *pucStart;     // storage area (for checking freed pointers)
+  uint8_t *pucEnd;
+  size_t xBlockSize;
+  volatile uint32_t ulFree;
+  uint32_t ulMinFree;    // low-water mark of free blocks
+} BufPool_t;
+
+/* Zero-copy channel */
+typedef struct {
+  MpscRing_t xRing;
+  TaskHandle_t volatile xReceiver;
+} Channel_t;
+
+void vBufPoolInit(BufPool_t *pxPool, void *pvStorage, size_t xBlockSize, uint32_t ulBlocks);
+void *pvBufPoolAlloc(BufPool_t *pxPool);
+void vBufPoolFree(BufPool_t *pxPool, void *pvBlock);
+uint32_t ulBufPoolGetFree(const BufPool_t *pxPool);
+uint32_t ulBufPoolGetMinFree(const BufPool_t *pxPool);
+
+void vChannelInit(Channel_t *pxChannel, void **ppvSlots, uint32_t ulSlots);
+BaseType_t xChannelSend(Channel_t *pxChannel, void *pvBuffer);
+BaseType_t xChannelSendFromISR(Channel_t *pxChannel, void *pvBuffer, BaseType_t *pxHigherPriorityTaskWoken);
+void *pvChannelReceive(Channel_t *pxChannel, TickType_t xTicksToWait);
+uint32_t ulChannelGetCount(const Channel_t *pxChannel);
+
+#endif /* BUFPOOL_H */
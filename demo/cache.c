@@ -0,0 +1,95 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Cache maintenance and cache-aware object placement
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Cache support and console */
+#include "cache.h"
+#include "console.h"
+
+#if ((configCACHE_LINE_SIZE & (configCACHE_LINE_SIZE - 1)) != 0) || (configCACHE_LINE_SIZE < portBYTE_ALIGNMENT)
+  #error "configCACHE_LINE_SIZE has to be a power of two >= portBYTE_ALIGNMENT!"
+#endif
+
+
+/******************************************************************************
+ * Get the data cache line (block) size in bytes; 0 if there is no d-cache.
+ ******************************************************************************/
+uint32_t ulCacheGetDataLineSize(void) {
+
+  if ((NEORV32_SYSINFO->SOC & (1 << SYSINFO_SOC_DCACHE)) == 0) {
+    return 0;
+  }
+  return 1u << ((NEORV32_SYSINFO->CACHE >> SYSINFO_CACHE_DATA_BLOCK_SIZE_0) & 0xf);
+}
+
+
+/******************************************************************************
+ * Report the cache configuration and check the alignment setup.
+ ******************************************************************************/
+void vCacheInit(void) {
+
+  uint32_t ulLineSize = ulCacheGetDataLineSize();
+  uint32_t ulSoc = NEORV32_SYSINFO->SOC;
+
+  if ((ulSoc & ((1 << SYSINFO_SOC_ICACHE) | (1 << SYSINFO_SOC_DCACHE))) == 0) {
+    return; // uncached system: nothing to do
+  }
+
+  vConsolePrintf("Caches: i-cache %s, d-cache %s (%u bytes/line)\n",
+                 (ulSoc & (1 << SYSINFO_SOC_ICACHE)) ? "on" : "off",
+                 (ulSoc & (1 << SYSINFO_SOC_DCACHE)) ? "on" : "off", ulLineSize);
+
+#if ( configUSE_CACHE_ALIGNMENT == 1 )
+  if (ulLineSize > configCACHE_LINE_SIZE) {
+    vConsolePrintf("WARNING! 'configCACHE_LINE_SIZE' (%u) is smaller than the d-cache line size!\n",
+                   (uint32_t)configCACHE_LINE_SIZE);
+  }
+#endif
+}
+
+
+#if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+/******************************************************************************
+ * Allocate a task stack aligned to (and padded to) whole cache lines. The
+ * original heap block is stored right below the stack.
+ ******************************************************************************/
+void *pvPortMallocStack(size_t xSize) {
+
+  uint8_t *pucBlock, *pucStack;
+
+  xSize = (xSize + configCACHE_LINE_SIZE - 1) & ~(size_t)(configCACHE_LINE_SIZE - 1);
+  pucBlock = (uint8_t *)pvPortMalloc(xSize + configCACHE_LINE_SIZE);
+  if (pucBlock == NULL) {
+    return NULL;
+  }
+
+  pucStack = (uint8_t *)(((uint32_t)pucBlock + sizeof(void *) + configCACHE_LINE_SIZE - 1) &
+                         ~(uint32_t)(configCACHE_LINE_SIZE - 1));
+  ((void **)pucStack)[-1] = pucBlock;
+  return pucStack;
+}
+
+
+/******************************************************************************
+ * Free a stack allocated by pvPortMallocStack().
+ ******************************************************************************/
+void vPortFreeStack(void *pv) {
+
+  if (pv != NULL) {
+    vPortFree(((void **)pv)[-1]);
+  }
+}
+#endif
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Cache maintenance and cache-aware object placement
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * The NEORV32 caches have no per-line maintenance operations: "fence" writes
+ * back and invalidates the complete data cache, "fence.i" invalidates the
+ * complete instruction cache. The range functions below take the buffer
+ * anyway so drivers are written against the usual interface:
+ *
+ *   vCacheCleanRange()      before a DMA/bus master reads a buffer
+ *   vCacheInvalidateRange() after a DMA/bus master wrote a buffer
+ *   vCacheSyncInstructions() after writing code (copying, patching)
+ *
+ * All functions are harmless (and cheap) without caches.
+ *
+ * configUSE_CACHE_ALIGNMENT aligns kernel objects to configCACHE_LINE_SIZE so
+ * TCBs, stacks and queue storage of different tasks never share a cache
+ * line: all configSTATIC_DATA objects (static allocation) or the task
+ * stacks (dynamic allocation, pvPortMallocStack()).
+ *
+ * configUSE_SCRATCHPAD places the scheduler's hot data (current TCB, ready
+ * and delayed lists, tick count, ISR stack) and all configSCRATCHPAD_DATA
+ * objects (e.g. the stacks and TCBs of the most frequently running tasks) in
+ * the uncached DMEM while everything else lives in cached external memory
+ * (scratchpad.ld).
+ ******************************************************************************/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+void vCacheInit(void);
+uint32_t ulCacheGetDataLineSize(void);
+
+
+/******************************************************************************
+ * Write back and invalidate the data cache.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vCacheSyncData(void) {
+
+  __asm volatile ("fence" : : : "memory");
+}
+
+
+/******************************************************************************
+ * Make a buffer visible to other bus masters / make their writes visible to
+ * the CPU.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vCacheCleanRange(const void *pvAddress, size_t xLength) {
+
+  (void)pvAddress;
+  (void)xLength;
+  vCacheSyncData();
+}
+
+static inline __attribute__((always_inline)) void vCacheInvalidateRange(void *pvAddress, size_t xLength) {
+
+  (void)pvAddress;
+  (void)xLength;
+  vCacheSyncData();
+}
+
+
+/******************************************************************************
+ * Make newly written code visible to the instruction fetch.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vCacheSyncInstructions(void) {
+
+  __asm volatile ("fence\n fence.i" : : : "memory");
+}
+
+#endif /* CACHE_H */
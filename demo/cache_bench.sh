@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+
+# Compare the kernel micro-benchmarks (benchmark.c) with and without caches.
+# The caches are enabled via top-level generics of the simulation testbench;
+# the generic names depend on the NEORV32 version and can be overridden:
+#   CACHE_GENERICS="-gICACHE_EN=true -gDCACHE_EN=true" cache_bench.sh [make options]
+
+set -e
+
+cd $(dirname "$0")
+
+CACHE_GENERICS=${CACHE_GENERICS:-"-gICACHE_EN=true -gDCACHE_EN=true"}
+TESTS="ctx_yield ctx_preempt queue_roundtrip sem_give_take notify_give_take isr_wake"
+declare -A RESULT
+
+for cfg in uncached cached; do
+  if [ "$cfg" = "cached" ]; then
+    make USER_FLAGS+="-DUART0_SIM_MODE" APP=benchmark CACHE=on "$@" clean_all exe install
+    make -i GHDL_RUN_FLAGS="--stop-time=10ms $CACHE_GENERICS" sim
+  else
+    make USER_FLAGS+="-DUART0_SIM_MODE" APP=benchmark "$@" clean_all exe install
+    make -i GHDL_RUN_FLAGS="--stop-time=10ms" sim
+  fi
+  grep -a '#BENCH-CFG:' ../neorv32/sim/ghdl.log | tail -n 1 || true
+
+  # minimum cycles of each test
+  for t in $TESTS; do
+    RESULT[$cfg,$t]=$(grep -a "#BENCH:$t " ../neorv32/sim/ghdl.log | tail -n 1 | awk '{print $2}')
+  done
+done
+
+echo ""
+printf "%-18s %9s %9s\n" "benchmark" "uncached" "cached"
+for t in $TESTS; do
+  printf "%-18s %9s %9s\n" "$t" "${RESULT[uncached,$t]:--}" "${RESULT[cached,$t]:--}"
+done
@@ -0,0 +1,640 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Interrupt-driven, ring-buffered UART0 console
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Console driver, FIRQ dispatcher, DMA and lock-free primitives */
+#include "console.h"
+#include "irq.h"
+#include "irq_mask.h"
+#include "dma.h"
+#include "lockfree.h"
+
+/* Hardware handle */
+#define consoleUART       (NEORV32_UART0)
+
+/* Ring buffer index masks */
+#define consoleTX_MASK    (configCONSOLE_TX_BUFFER_SIZE - 1)
+#define consoleRX_MASK    (configCONSOLE_RX_BUFFER_SIZE - 1)
+
+#if ((configCONSOLE_TX_BUFFER_SIZE & consoleTX_MASK) != 0) || ((configCONSOLE_RX_BUFFER_SIZE & consoleRX_MASK) != 0)
+  #error "configCONSOLE_TX_BUFFER_SIZE and configCONSOLE_RX_BUFFER_SIZE have to be a power of two!"
+#endif
+
+/* Ring buffers; head and tail indices are free-running and masked on access. The TX ring has several
+ * producers (tasks and interrupt handlers) and is accessed with interrupts masked; the RX ring has a
+ * single producer (RX interrupt) and a single consumer (reader task) and is lock-free. */
+static char cTxBuffer[configCONSOLE_TX_BUFFER_SIZE];
+static char cRxBuffer[configCONSOLE_RX_BUFFER_SIZE];
+static volatile uint32_t ulTxHead = 0, ulTxTail = 0;
+static volatile uint32_t ulRxHead = 0, ulRxTail = 0;
+
+/* Tasks currently blocked on the console (at most one per direction) */
+static TaskHandle_t volatile xTxWaiter = NULL;
+static TaskHandle_t volatile xRxWaiter = NULL;
+
+/* Serializes blocking writers so there is only a single TX waiter at a time */
+static SemaphoreHandle_t xTxMutex = NULL;
+
+/* Number of bytes that had to be discarded (TX buffer full or RX overrun) */
+static volatile uint32_t ulDropped = 0;
+
+/* DMA output (xConsoleWriteDma()): data not submitted yet, chunk in flight, completed bytes, waiting task */
+static const char *volatile pcTxDmaData = NULL;
+static volatile size_t xTxDmaLeft = 0;
+static volatile size_t xTxDmaSent = 0;
+static volatile BaseType_t xTxDmaActive = pdFALSE;
+static volatile BaseType_t xTxDmaBusy = pdFALSE;
+static TaskHandle_t volatile xTxDmaWaiter = NULL;
+static DmaTransfer_t xTxDmaTransfer;
+static uint32_t ulTxFifoDepth = 1;
+
+/* Prototypes */
+static size_t prvTxEnqueue(const char *pcData, size_t xLength, BaseType_t xCooked);
+static size_t prvWrite(const char *pcBuffer, size_t xLength, TickType_t xTicksToWait, BaseType_t xCooked);
+static void prvPolledPutc(char c);
+static void prvRxHandler(void *pvContext);
+static void prvTxHandler(void *pvContext);
+static void prvTxDmaNext(BaseType_t *pxHigherPriorityTaskWoken);
+static void prvTxDmaDone(void *pvContext);
+static size_t prvFormat(char *pcBuffer, size_t xSize, const char *pcFormat, va_list xArgs);
+
+
+/******************************************************************************
+ * Setup UART0 and enable the RX interrupt. The TX interrupt is only enabled
+ * while there is data in the TX ring buffer.
+ ******************************************************************************/
+void vConsoleInit(uint32_t ulBaudRate) {
+
+  ulTxHead = ulTxTail = 0;
+  ulRxHead = ulRxTail = 0;
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  static StaticSemaphore_t xTxMutexBuffer configSTATIC_DATA;
+  xTxMutex = xSemaphoreCreateMutexStatic(&xTxMutexBuffer);
+#else
+  xTxMutex = xSemaphoreCreateMutex();
+#endif
+  configASSERT(xTxMutex != NULL);
+
+  neorv32_uart_setup(consoleUART, ulBaudRate, 1 << UART_CTRL_IRQ_RX_NEMPTY);
+  ulTxFifoDepth = (uint32_t)neorv32_uart_get_tx_fifo_depth(consoleUART);
+  xNeorv32IrqAttach(neorv32IRQ_CHANNEL(UART0_RX_TRAP_CODE), prvRxHandler, NULL);
+  xNeorv32IrqAttach(neorv32IRQ_CHANNEL(UART0_TX_TRAP_CODE), prvTxHandler, NULL);
+}
+
+
+/******************************************************************************
+ * Copy data into the TX ring buffer and start the transmitter. Line feeds
+ * are expanded to CR+LF if xCooked is set. Has to be called with interrupts
+ * disabled. Returns the number of consumed source bytes.
+ ******************************************************************************/
+static size_t prvTxEnqueue(const char *pcData, size_t xLength, BaseType_t xCooked) {
+
+  size_t xCount = 0;
+  uint32_t ulHead = ulTxHead;
+  uint32_t ulFree = configCONSOLE_TX_BUFFER_SIZE - (ulHead - ulTxTail);
+
+  while (xCount < xLength) {
+    char c = pcData[xCount];
+    if ((xCooked != pdFALSE) && (c == '\n')) {
+      if (ulFree < 2) {
+        break;
+      }
+      cTxBuffer[ulHead++ & consoleTX_MASK] = '\r';
+      ulFree--;
+    }
+    else if (ulFree < 1) {
+      break;
+    }
+    cTxBuffer[ulHead++ & consoleTX_MASK] = c;
+    ulFree--;
+    xCount++;
+  }
+
+  if (ulHead != ulTxHead) {
+    ulTxHead = ulHead;
+    if (xTxDmaBusy == pdFALSE) { // the FIFO must not be written while a DMA chunk is in flight
+      consoleUART->CTRL |= 1 << UART_CTRL_IRQ_TX_EMPTY; // TX FIFO empty interrupt refills the FIFO
+    }
+  }
+
+  return xCount;
+}
+
+
+/******************************************************************************
+ * Send a single character by polling.
+ ******************************************************************************/
+static void prvPolledPutc(char c) {
+
+  while ((consoleUART->CTRL & (1 << UART_CTRL_TX_NFULL)) == 0);
+  consoleUART->DATA = (uint32_t)c;
+}
+
+
+/******************************************************************************
+ * Non-blocking string output. Can be called from tasks and from interrupt
+ * handlers. Characters that do not fit into the TX buffer are dropped.
+ ******************************************************************************/
+void vConsolePuts(const char *pcString) {
+
+  size_t xLength = strlen(pcString);
+  size_t xSent;
+  uint32_t ulStatus;
+
+  if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+    neorv32_uart_puts(consoleUART, pcString); // no interrupts yet, use polling
+    return;
+  }
+
+  ulStatus = ulIrqMaskSave();
+  xSent = prvTxEnqueue(pcString, xLength, pdTRUE);
+  vIrqMaskRestore(ulStatus);
+  ulAtomicFetchAdd(&ulDropped, xLength - xSent);
+}
+
+
+/******************************************************************************
+ * Non-blocking formatted output (see prvFormat() for supported formats).
+ * Output is truncated to configCONSOLE_PRINTF_BUFFER_SIZE-1 characters.
+ ******************************************************************************/
+void vConsolePrintf(const char *pcFormat, ...) {
+
+  char cBuffer[configCONSOLE_PRINTF_BUFFER_SIZE];
+  va_list xArgs;
+  size_t xLength;
+
+  va_start(xArgs, pcFormat);
+  xLength = prvFormat(cBuffer, sizeof(cBuffer) - 1, pcFormat, xArgs);
+  va_end(xArgs);
+
+  cBuffer[xLength] = '\0';
+  vConsolePuts(cBuffer);
+}
+
+
+/******************************************************************************
+ * Blocking formatted output (see prvFormat() for supported formats). Blocks
+ * the calling task until the whole text has been put into the TX buffer.
+ ******************************************************************************/
+void vConsolePrintfBlocking(const char *pcFormat, ...) {
+
+  char cBuffer[configCONSOLE_PRINTF_BUFFER_SIZE];
+  va_list xArgs;
+  size_t xLength;
+
+  va_start(xArgs, pcFormat);
+  xLength = prvFormat(cBuffer, sizeof(cBuffer), pcFormat, xArgs);
+  va_end(xArgs);
+
+  prvWrite(cBuffer, xLength, portMAX_DELAY, pdTRUE);
+}
+
+
+/******************************************************************************
+ * Blocking raw (binary-safe) output. Blocks the calling task for up to
+ * xTicksToWait until all data has been put into the TX buffer. Returns the
+ * number of bytes written.
+ ******************************************************************************/
+size_t xConsoleWrite(const char *pcBuffer, size_t xLength, TickType_t xTicksToWait) {
+
+  return prvWrite(pcBuffer, xLength, xTicksToWait, pdFALSE);
+}
+
+
+/******************************************************************************
+ * Blocking raw output using the DMA controller. The data is sent directly
+ * from pcBuffer in chunks of the UART's TX FIFO depth (the DMA has no flow
+ * control); each chunk is started by the TX FIFO empty interrupt, so the CPU
+ * only handles two interrupts per chunk. Blocks the calling task until all
+ * data has left the TX FIFO (pending ring buffer output is sent first, so
+ * xLength = 0 just waits for it). Falls back to xConsoleWrite() if there is
+ * no DMA controller. Returns the number of bytes written.
+ ******************************************************************************/
+size_t xConsoleWriteDma(const char *pcBuffer, size_t xLength) {
+
+  uint32_t ulStatus;
+  size_t xSent;
+
+  if ((xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) || (xDmaIsAvailable() == pdFALSE)) {
+    return prvWrite(pcBuffer, xLength, portMAX_DELAY, pdFALSE);
+  }
+
+  xSemaphoreTake(xTxMutex, portMAX_DELAY);
+
+  ulStatus = ulIrqMaskSave();
+  pcTxDmaData = pcBuffer;
+  xTxDmaLeft = xLength;
+  xTxDmaSent = 0;
+  xTxDmaActive = pdTRUE;
+  xTxDmaWaiter = xTaskGetCurrentTaskHandle();
+  consoleUART->CTRL |= 1 << UART_CTRL_IRQ_TX_EMPTY;
+  vIrqMaskRestore(ulStatus);
+
+  while (xTxDmaActive != pdFALSE) {
+    ulTaskNotifyTakeIndexed(configCONSOLE_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+  }
+  xSent = xTxDmaSent;
+
+  xSemaphoreGive(xTxMutex);
+  return xSent;
+}
+
+
+/******************************************************************************
+ * Blocking output backend. Blocking writers are serialized by a mutex so
+ * their output does not interleave.
+ ******************************************************************************/
+static size_t prvWrite(const char *pcBuffer, size_t xLength, TickType_t xTicksToWait, BaseType_t xCooked) {
+
+  size_t xSent = 0;
+  uint32_t ulStatus;
+  TimeOut_t xTimeOut;
+
+  if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+    while (xSent < xLength) { // no interrupts yet, use polling
+      if ((xCooked != pdFALSE) && (pcBuffer[xSent] == '\n')) {
+        prvPolledPutc('\r');
+      }
+      prvPolledPutc(pcBuffer[xSent++]);
+    }
+    return xSent;
+  }
+
+  vTaskSetTimeOutState(&xTimeOut);
+  if (xSemaphoreTake(xTxMutex, xTicksToWait) != pdTRUE) {
+    return 0;
+  }
+
+  while (1) {
+    ulStatus = ulIrqMaskSave();
+    xSent += prvTxEnqueue(&pcBuffer[xSent], xLength - xSent, xCooked);
+    if (xSent < xLength) {
+      xTxWaiter = xTaskGetCurrentTaskHandle();
+    }
+    vIrqMaskRestore(ulStatus);
+
+    if ((xSent == xLength) || (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)) {
+      break;
+    }
+    ulTaskNotifyTakeIndexed(configCONSOLE_NOTIFY_INDEX, pdTRUE, xTicksToWait);
+  }
+
+  xTxWaiter = NULL;
+  xSemaphoreGive(xTxMutex);
+  return xSent;
+}
+
+
+/******************************************************************************
+ * Blocking input. Blocks the calling task for up to xTicksToWait until at
+ * least one byte has been received. Returns the number of bytes read. Only
+ * one task may read at a time (single consumer of the RX ring).
+ ******************************************************************************/
+size_t xConsoleRead(char *pcBuffer, size_t xLength, TickType_t xTicksToWait) {
+
+  size_t xCount = 0;
+  uint32_t ulHead, ulTail;
+  TimeOut_t xTimeOut;
+
+  vTaskSetTimeOutState(&xTimeOut);
+
+  while (1) {
+    // register before looking at the ring, so a byte received in between still notifies this task
+    xRxWaiter = xTaskGetCurrentTaskHandle();
+    lockfreeFENCE();
+    ulHead = ulRxHead;
+    ulTail = ulRxTail;
+    lockfreeFENCE(); // index before data
+    while ((xCount < xLength) && (ulTail != ulHead)) {
+      pcBuffer[xCount++] = cRxBuffer[ulTail++ & consoleRX_MASK];
+    }
+    lockfreeFENCE(); // data before the space is released
+    ulRxTail = ulTail;
+
+    if ((xCount != 0) || (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)) {
+      break;
+    }
+    ulTaskNotifyTakeIndexed(configCONSOLE_NOTIFY_INDEX, pdTRUE, xTicksToWait);
+  }
+
+  xRxWaiter = NULL;
+  return xCount;
+}
+
+
+/******************************************************************************
+ * Drain the TX buffer by polling. Intended for fault handlers that run with
+ * interrupts disabled.
+ ******************************************************************************/
+void vConsoleFlush(void) {
+
+  uint32_t ulStatus = ulIrqMaskSave();
+
+  while (ulTxTail != ulTxHead) {
+    prvPolledPutc(cTxBuffer[ulTxTail++ & consoleTX_MASK]);
+  }
+  consoleUART->CTRL &= ~(1 << UART_CTRL_IRQ_TX_EMPTY);
+
+  vIrqMaskRestore(ulStatus);
+}
+
+
+/******************************************************************************
+ * Flush the TX buffer and send a string by polling. Intended for fault
+ * handlers that run with interrupts disabled.
+ ******************************************************************************/
+void vConsolePanicPuts(const char *pcString) {
+
+  vConsoleFlush();
+  neorv32_uart_puts(consoleUART, pcString);
+}
+
+
+/******************************************************************************
+ * Get number of dropped bytes (TX buffer full or RX buffer overrun).
+ ******************************************************************************/
+uint32_t ulConsoleGetDropped(void) {
+
+  return ulDropped;
+}
+
+
+/******************************************************************************
+ * UART0 RX interrupt: move all received bytes from the RX FIFO into the RX
+ * ring buffer and wake up a blocked reader. The RX ring is only written here,
+ * so interrupts stay enabled (nested handlers only touch the TX side).
+ ******************************************************************************/
+configFAST_TEXT static void prvRxHandler(void *pvContext) {
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  uint32_t ulHead = ulRxHead;
+  TaskHandle_t xWaiter;
+  char c;
+
+  (void)pvContext;
+
+  while (consoleUART->CTRL & (1 << UART_CTRL_RX_NEMPTY)) {
+    c = (char)(consoleUART->DATA & 0xffu);
+    if ((ulHead - ulRxTail) < configCONSOLE_RX_BUFFER_SIZE) {
+      cRxBuffer[ulHead++ & consoleRX_MASK] = c;
+    }
+    else {
+      ulAtomicFetchAdd(&ulDropped, 1); // overrun
+    }
+  }
+  lockfreeFENCE(); // data before index
+  ulRxHead = ulHead;
+  lockfreeFENCE(); // index before the waiter check (see xConsoleRead())
+
+  xWaiter = xRxWaiter;
+  if (xWaiter != NULL) {
+    vTaskNotifyGiveIndexedFromISR(xWaiter, configCONSOLE_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+  }
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+
+/******************************************************************************
+ * UART0 TX interrupt: refill the TX FIFO from the TX ring buffer and wake up
+ * a blocked writer. The interrupt is disabled again when the buffer is empty.
+ * During a DMA write the next chunk is started once the ring buffer is empty.
+ * Runs with interrupts masked (nested handlers may write to the console).
+ ******************************************************************************/
+configFAST_TEXT static void prvTxHandler(void *pvContext) {
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  uint32_t ulStatus = ulIrqMaskSave();
+  uint32_t ulTail = ulTxTail;
+
+  (void)pvContext;
+
+  while ((ulTail != ulTxHead) && (consoleUART->CTRL & (1 << UART_CTRL_TX_NFULL))) {
+    consoleUART->DATA = (uint32_t)cTxBuffer[ulTail++ & consoleTX_MASK];
+  }
+  ulTxTail = ulTail;
+
+  if (ulTail == ulTxHead) {
+    if ((xTxDmaActive != pdFALSE) && (consoleUART->CTRL & (1 << UART_CTRL_TX_EMPTY))) {
+      prvTxDmaNext(&xHigherPriorityTaskWoken);
+    }
+    else if (xTxDmaActive == pdFALSE) {
+      consoleUART->CTRL &= ~(1 << UART_CTRL_IRQ_TX_EMPTY);
+    }
+  }
+
+  if (xTxWaiter != NULL) {
+    vTaskNotifyGiveIndexedFromISR(xTxWaiter, configCONSOLE_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+    xTxWaiter = NULL;
+  }
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  vIrqMaskRestore(ulStatus);
+}
+
+
+/******************************************************************************
+ * Start the next chunk of a DMA write (TX FIFO empty, interrupts masked). The
+ * TX interrupt stays disabled until the chunk has been moved into the FIFO
+ * (prvTxDmaDone()). Completes the write if there is no data left.
+ ******************************************************************************/
+configFAST_TEXT static void prvTxDmaNext(BaseType_t *pxHigherPriorityTaskWoken) {
+
+  size_t xChunk = xTxDmaLeft;
+
+  if (xChunk > ulTxFifoDepth) {
+    xChunk = ulTxFifoDepth;
+  }
+
+  if (xChunk != 0) {
+    vDmaPrepare(&xTxDmaTransfer, pcTxDmaData, &consoleUART->DATA, xChunk,
+                DMA_CMD_B2UW | DMA_CMD_SRC_INC | DMA_CMD_DST_CONST);
+    vDmaSetCallback(&xTxDmaTransfer, prvTxDmaDone, NULL);
+    xTxDmaBusy = pdTRUE;
+    if (xDmaSubmit(&xTxDmaTransfer) == pdPASS) {
+      pcTxDmaData += xChunk;
+      xTxDmaLeft -= xChunk;
+      consoleUART->CTRL &= ~(1 << UART_CTRL_IRQ_TX_EMPTY);
+      return;
+    }
+    xTxDmaBusy = pdFALSE;
+  }
+
+  // all data sent (or the DMA failed)
+  xTxDmaLeft = 0;
+  xTxDmaActive = pdFALSE;
+  consoleUART->CTRL &= ~(1 << UART_CTRL_IRQ_TX_EMPTY);
+  if (xTxDmaWaiter != NULL) {
+    vTaskNotifyGiveIndexedFromISR(xTxDmaWaiter, configCONSOLE_NOTIFY_INDEX, pxHigherPriorityTaskWoken);
+    xTxDmaWaiter = NULL;
+  }
+}
+
+
+/******************************************************************************
+ * DMA completion of a TX chunk (interrupt context): count the data and let
+ * the TX FIFO empty interrupt start the next chunk. A bus error aborts the
+ * write.
+ ******************************************************************************/
+configFAST_TEXT static void prvTxDmaDone(void *pvContext) {
+
+  uint32_t ulStatus = ulIrqMaskSave();
+
+  (void)pvContext;
+
+  if (xTxDmaTransfer.eState == eDmaDone) {
+    xTxDmaSent += xTxDmaTransfer.ulCount;
+  }
+  else {
+    xTxDmaLeft = 0;
+  }
+  xTxDmaBusy = pdFALSE;
+  consoleUART->CTRL |= 1 << UART_CTRL_IRQ_TX_EMPTY;
+  vIrqMaskRestore(ulStatus);
+}
+
+
+/******************************************************************************
+ * Minimal vsnprintf replacement (the newlib version is way too big for the
+ * IMEM). Supports %c, %s, %d, %i, %u, %x, %X, %p and %% with optional '-'
+ * and '0' flags and a field width. An 'l' length modifier is ignored (long is
+ * 32-bit). Returns the number of characters written (no terminating zero).
+ ******************************************************************************/
+static size_t prvFormat(char *pcBuffer, size_t xSize, const char *pcFormat, va_list xArgs) {
+
+  static const char cDigits[] = "0123456789abcdef0123456789ABCDEF";
+  char cNumber[12];
+  const char *pcStr;
+  size_t xPos = 0;
+  int iWidth, iLength, iPad, iLeft, iNegative;
+  char cPad, cSpec;
+  uint32_t ulValue, ulBase, ulCase;
+
+  while ((*pcFormat != '\0') && (xPos < xSize)) {
+
+    if (*pcFormat != '%') {
+      pcBuffer[xPos++] = *pcFormat++;
+      continue;
+    }
+    pcFormat++;
+
+    // flags, width and length
+    iLeft = 0;
+    cPad = ' ';
+    iWidth = 0;
+    if (*pcFormat == '-') {
+      iLeft = 1;
+      pcFormat++;
+    }
+    if (*pcFormat == '0') {
+      cPad = '0';
+      pcFormat++;
+    }
+    while ((*pcFormat >= '0') && (*pcFormat <= '9')) {
+      iWidth = (iWidth * 10) + (*pcFormat++ - '0');
+    }
+    if (*pcFormat == 'l') {
+      pcFormat++;
+    }
+    cSpec = *pcFormat;
+    if (cSpec == '\0') {
+      break;
+    }
+    pcFormat++;
+
+    // convert argument
+    pcStr = cNumber;
+    iLength = 0;
+    iNegative = 0;
+    switch (cSpec) {
+      case 'c':
+        cNumber[0] = (char)va_arg(xArgs, int);
+        iLength = 1;
+        break;
+      case 's':
+        pcStr = va_arg(xArgs, const char *);
+        if (pcStr == NULL) {
+          pcStr = "(null)";
+        }
+        iLength = (int)strlen(pcStr);
+        break;
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'p':
+        if (cSpec == 'p') {
+          ulValue = (uint32_t)va_arg(xArgs, void *);
+          cPad = '0';
+          iWidth = 8;
+        }
+        else {
+          ulValue = va_arg(xArgs, uint32_t);
+        }
+        ulBase = ((cSpec == 'd') || (cSpec == 'i') || (cSpec == 'u')) ? 10 : 16;
+        ulCase = (cSpec == 'X') ? 16 : 0;
+        if (((cSpec == 'd') || (cSpec == 'i')) && ((int32_t)ulValue < 0)) {
+          iNegative = 1;
+          ulValue = -ulValue;
+        }
+        iLength = sizeof(cNumber);
+        do { // digits are generated right-to-left
+          cNumber[--iLength] = cDigits[(ulValue % ulBase) + ulCase];
+          ulValue /= ulBase;
+        } while (ulValue != 0);
+        pcStr = &cNumber[iLength];
+        iLength = sizeof(cNumber) - iLength;
+        break;
+      default: // also handles '%%'
+        cNumber[0] = cSpec;
+        iLength = 1;
+        break;
+    }
+
+    // emit
+    if (iNegative) {
+      if (cPad == '0') {
+        if (xPos < xSize) {
+          pcBuffer[xPos++] = '-';
+        }
+        iWidth--;
+      }
+      else {
+        *(char *)--pcStr = '-'; // there is always room left in cNumber
+        iLength++;
+      }
+    }
+    iPad = (iWidth > iLength) ? (iWidth - iLength) : 0;
+    if (!iLeft) {
+      while ((iPad > 0) && (xPos < xSize)) {
+        pcBuffer[xPos++] = cPad;
+        iPad--;
+      }
+    }
+    while ((iLength > 0) && (xPos < xSize)) {
+      pcBuffer[xPos++] = *pcStr++;
+      iLength--;
+    }
+    while ((iPad > 0) && (xPos < xSize)) {
+      pcBuffer[xPos++] = ' ';
+      iPad--;
+    }
+  }
+
+  return xPos;
+}
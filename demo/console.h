@@ -0,0 +1,46 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Interrupt-driven, ring-buffered UART0 console
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * TX and RX data is buffered in two software ring buffers that are fed by the
+ * UART0 FIFO interrupts. Writers never poll the UART: text is enqueued and
+ * the TX interrupt moves it into the hardware FIFO at full line rate.
+ *
+ * - vConsolePuts() / vConsolePrintf() never block and can be used from tasks
+ *   and from interrupt handlers; data that does not fit is dropped (and
+ *   counted).
+ * - xConsoleWrite() / vConsolePrintfBlocking() / xConsoleRead() block the
+ *   calling task (using a direct to task notification) until there is space /
+ *   data. Blocking writers are serialized by a mutex; as with FreeRTOS stream
+ *   buffers only a single task may block on reading at a time.
+ * - xConsoleWriteDma() sends a buffer using the DMA controller in chunks of
+ *   the TX FIFO depth and blocks until it has been sent; the CPU only
+ *   handles two interrupts per chunk meanwhile.
+ * - vConsoleFlush() / vConsolePanicPuts() drain the buffers by polling and
+ *   are meant for fault handlers running with interrupts disabled.
+ *
+ * Before the scheduler has been started all output is sent by polling.
+ ******************************************************************************/
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+
+void   vConsoleInit(uint32_t ulBaudRate);
+void   vConsolePuts(const char *pcString);
+void   vConsolePrintf(const char *pcFormat, ...) __attribute__((format(printf, 1, 2)));
+void   vConsolePrintfBlocking(const char *pcFormat, ...) __attribute__((format(printf, 1, 2)));
+size_t xConsoleWrite(const char *pcBuffer, size_t xLength, TickType_t xTicksToWait);
+size_t xConsoleWriteDma(const char *pcBuffer, size_t xLength);
+size_t xConsoleRead(char *pcBuffer, size_t xLength, TickType_t xTicksToWait);
+void   vConsoleFlush(void);
+void   vConsolePanicPuts(const char *pcString);
+uint32_t ulConsoleGetDropped(void);
+
+#endif /* CONSOLE_H */
@@ -0,0 +1,359 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Stackless coroutines
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Coroutine API, FIRQ dispatcher and atomic event bits */
+#include "coro.h"
+#include "irq.h"
+#include "irq_mask.h"
+#include "lockfree.h"
+
+/* Prototypes */
+static BaseType_t prvIsReady(Coro_t *pxCoro);
+static TickType_t prvTicksToWait(const Coro_t *pxCoro);
+static void prvUnlink(Coro_t *pxCoro, Coro_t *pxPrev);
+static void prvIrqHandler(void *pvContext);
+static void prvWakeExecutor(void);
+static void prvWakeExecutorFromISR(BaseType_t *pxHigherPriorityTaskWoken);
+
+/* All coroutines (new ones are added at the head) */
+static Coro_t *volatile pxCoroList = NULL;
+
+/* Task running vCoroRun() */
+static TaskHandle_t volatile xExecutor = NULL;
+
+/* Set if a coroutine has notified another one during the current pass */
+static volatile BaseType_t xRescan = pdFALSE;
+
+
+/******************************************************************************
+ * Add a coroutine to the executor. It starts at coroBEGIN() on the next
+ * executor pass. The control block has to stay valid until the coroutine
+ * has finished (coroEND()).
+ ******************************************************************************/
+void vCoroCreate(Coro_t *pxCoro, CoroFunction_t pxFunction, void *pvContext) {
+
+  uint32_t ulStatus;
+
+  pxCoro->pxFunction = pxFunction;
+  pxCoro->pvContext = pvContext;
+  pxCoro->ulResume = 0;
+  pxCoro->ucBlock = coroBLOCK_NONE;
+  pxCoro->ulEvents = 0;
+  pxCoro->ulWaitMask = 0;
+  pxCoro->xQueue = NULL;
+
+  ulStatus = ulIrqMaskSave();
+  pxCoro->pxNext = pxCoroList;
+  pxCoroList = pxCoro;
+  vIrqMaskRestore(ulStatus);
+
+  vCoroNotify(pxCoro, 0); // wake up the executor
+}
+
+
+/******************************************************************************
+ * Set event bits of a coroutine (task or coroutine context).
+ ******************************************************************************/
+void vCoroNotify(Coro_t *pxCoro, uint32_t ulBits) {
+
+  ulAtomicFetchOr(&pxCoro->ulEvents, ulBits);
+  prvWakeExecutor();
+}
+
+
+/******************************************************************************
+ * Set event bits of a coroutine (interrupt context).
+ ******************************************************************************/
+configFAST_TEXT void vCoroNotifyFromISR(Coro_t *pxCoro, uint32_t ulBits, BaseType_t *pxHigherPriorityTaskWoken) {
+
+  ulAtomicFetchOr(&pxCoro->ulEvents, ulBits);
+  prvWakeExecutorFromISR(pxHigherPriorityTaskWoken);
+}
+
+
+/******************************************************************************
+ * Make the executor check its coroutines again (task or coroutine context).
+ ******************************************************************************/
+static void prvWakeExecutor(void) {
+
+  TaskHandle_t xTask = xExecutor;
+
+  if (xTask == NULL) {
+    return; // executor not running yet
+  }
+  if (xTask == xTaskGetCurrentTaskHandle()) {
+    xRescan = pdTRUE; // called by a coroutine: no need to wake up the executor
+  }
+  else {
+    xTaskNotifyGiveIndexed(xTask, configCORO_NOTIFY_INDEX);
+  }
+}
+
+
+/******************************************************************************
+ * Make the executor check its coroutines again (interrupt context).
+ ******************************************************************************/
+configFAST_TEXT static void prvWakeExecutorFromISR(BaseType_t *pxHigherPriorityTaskWoken) {
+
+  TaskHandle_t xTask = xExecutor;
+
+  if (xTask != NULL) {
+    vTaskNotifyGiveIndexedFromISR(xTask, configCORO_NOTIFY_INDEX, pxHigherPriorityTaskWoken);
+  }
+}
+
+
+/******************************************************************************
+ * Send an item to a queue that coroutines may wait for (task or coroutine
+ * context); wakes the executor if the item was sent.
+ ******************************************************************************/
+BaseType_t xCoroQueueSend(QueueHandle_t xQueue, const void *pvItem, TickType_t xTicksToWait) {
+
+  BaseType_t xResult = xQueueSend(xQueue, pvItem, xTicksToWait);
+
+  if (xResult == pdPASS) {
+    prvWakeExecutor();
+  }
+  return xResult;
+}
+
+
+/******************************************************************************
+ * Receive an item from a queue that coroutines may wait for (task or
+ * coroutine context); wakes the executor if an item was received.
+ ******************************************************************************/
+BaseType_t xCoroQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait) {
+
+  BaseType_t xResult = xQueueReceive(xQueue, pvBuffer, xTicksToWait);
+
+  if (xResult == pdPASS) {
+    prvWakeExecutor();
+  }
+  return xResult;
+}
+
+
+/******************************************************************************
+ * Send an item to a queue that coroutines may wait for (interrupt context).
+ ******************************************************************************/
+configFAST_TEXT BaseType_t xCoroQueueSendFromISR(QueueHandle_t xQueue, const void *pvItem, BaseType_t *pxHigherPriorityTaskWoken) {
+
+  BaseType_t xResult = xQueueSendFromISR(xQueue, pvItem, pxHigherPriorityTaskWoken);
+
+  if (xResult == pdPASS) {
+    prvWakeExecutorFromISR(pxHigherPriorityTaskWoken);
+  }
+  return xResult;
+}
+
+
+/******************************************************************************
+ * Receive an item from a queue that coroutines may wait for (interrupt
+ * context).
+ ******************************************************************************/
+configFAST_TEXT BaseType_t xCoroQueueReceiveFromISR(QueueHandle_t xQueue, void *pvBuffer, BaseType_t *pxHigherPriorityTaskWoken) {
+
+  BaseType_t xResult = xQueueReceiveFromISR(xQueue, pvBuffer, pxHigherPriorityTaskWoken);
+
+  if (xResult == pdPASS) {
+    prvWakeExecutorFromISR(pxHigherPriorityTaskWoken);
+  }
+  return xResult;
+}
+
+
+/******************************************************************************
+ * Get and clear the pending event bits of ulMask.
+ ******************************************************************************/
+uint32_t ulCoroTakeEvents(Coro_t *pxCoro, uint32_t ulMask) {
+
+  return ulAtomicFetchAnd(&pxCoro->ulEvents, ~ulMask) & ulMask;
+}
+
+
+/******************************************************************************
+ * Check if the timeout of the current wait has expired.
+ ******************************************************************************/
+BaseType_t xCoroTimedOut(const Coro_t *pxCoro) {
+
+  if (pxCoro->xWaitTicks == portMAX_DELAY) {
+    return pdFALSE;
+  }
+  return ((TickType_t)(xTaskGetTickCount() - pxCoro->xWaitStart) >= pxCoro->xWaitTicks) ? pdTRUE : pdFALSE;
+}
+
+
+/******************************************************************************
+ * Deliver a FIRQ / software interrupt channel to a coroutine: the channel
+ * is disabled and the coroutine gets coroEVENT_IRQ. The coroutine re-enables
+ * the channel (vNeorv32IrqEnable()) after it has serviced the peripheral,
+ * like a deferred handler task (see irq.h).
+ ******************************************************************************/
+BaseType_t xCoroAttachIrq(uint32_t ulChannel, Coro_t *pxCoro) {
+
+  if (pxCoro == NULL) {
+    return pdFAIL;
+  }
+  return xNeorv32IrqAttach(ulChannel, prvIrqHandler, (void *)pxCoro);
+}
+
+
+/******************************************************************************
+ * Interrupt handler of channels attached to a coroutine.
+ ******************************************************************************/
+configFAST_TEXT static void prvIrqHandler(void *pvContext) {
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+  vNeorv32IrqDisable(ulNeorv32IrqGetChannel(neorv32_cpu_csr_read(CSR_MCAUSE)));
+  vCoroNotifyFromISR((Coro_t *)pvContext, coroEVENT_IRQ, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+
+/******************************************************************************
+ * Check if a waiting coroutine can continue.
+ ******************************************************************************/
+static BaseType_t prvIsReady(Coro_t *pxCoro) {
+
+  switch (pxCoro->ucBlock) {
+    case coroBLOCK_NONE:
+      return pdTRUE;
+    case coroBLOCK_EVENTS:
+      if (pxCoro->ulEvents & pxCoro->ulWaitMask) {
+        return pdTRUE;
+      }
+      break;
+    case coroBLOCK_QUEUE_RX:
+      if (uxQueueMessagesWaiting(pxCoro->xQueue) != 0) {
+        return pdTRUE;
+      }
+      break;
+    case coroBLOCK_QUEUE_TX:
+      if (uxQueueSpacesAvailable(pxCoro->xQueue) != 0) {
+        return pdTRUE;
+      }
+      break;
+    case coroBLOCK_DONE:
+      return pdFALSE;
+    default:
+      break;
+  }
+  return xCoroTimedOut(pxCoro);
+}
+
+
+/******************************************************************************
+ * Ticks until a waiting coroutine has to be checked again.
+ ******************************************************************************/
+static TickType_t prvTicksToWait(const Coro_t *pxCoro) {
+
+  TickType_t xElapsed, xTicks = portMAX_DELAY;
+
+  if (pxCoro->ucBlock == coroBLOCK_NONE) {
+    return 0;
+  }
+
+  if (pxCoro->xWaitTicks != portMAX_DELAY) {
+    xElapsed = xTaskGetTickCount() - pxCoro->xWaitStart;
+    xTicks = (xElapsed >= pxCoro->xWaitTicks) ? 0 : (pxCoro->xWaitTicks - xElapsed);
+  }
+#if ( configCORO_POLL_TICKS > 0 )
+  if ((pxCoro->ucBlock == coroBLOCK_QUEUE_RX) || (pxCoro->ucBlock == coroBLOCK_QUEUE_TX)) {
+    if (xTicks > configCORO_POLL_TICKS) {
+      xTicks = configCORO_POLL_TICKS;
+    }
+  }
+#endif
+  return xTicks;
+}
+
+
+/******************************************************************************
+ * Remove a finished coroutine from the list. Coroutines created meanwhile
+ * have been added at the head, so the predecessor of the first one visited
+ * in this pass has to be looked up.
+ ******************************************************************************/
+static void prvUnlink(Coro_t *pxCoro, Coro_t *pxPrev) {
+
+  uint32_t ulStatus = ulIrqMaskSave();
+
+  if (pxPrev == NULL) {
+    if (pxCoroList == pxCoro) {
+      pxCoroList = pxCoro->pxNext;
+    }
+    else {
+      pxPrev = pxCoroList;
+      while (pxPrev->pxNext != pxCoro) {
+        pxPrev = pxPrev->pxNext;
+      }
+    }
+  }
+  if (pxPrev != NULL) {
+    pxPrev->pxNext = pxCoro->pxNext;
+  }
+
+  vIrqMaskRestore(ulStatus);
+}
+
+
+/******************************************************************************
+ * Run the coroutines in the calling task until all of them have finished.
+ * Every pass resumes each ready coroutine once; the task sleeps until the
+ * next notification or timeout if none is ready.
+ ******************************************************************************/
+void vCoroRun(void) {
+
+  Coro_t *pxCoro, *pxPrev;
+  TickType_t xSleep, xTicks;
+
+  xExecutor = xTaskGetCurrentTaskHandle();
+
+  while (pxCoroList != NULL) {
+    xRescan = pdFALSE;
+    xSleep = portMAX_DELAY;
+    pxPrev = NULL;
+    pxCoro = pxCoroList;
+
+    while (pxCoro != NULL) {
+      if (prvIsReady(pxCoro) != pdFALSE) {
+        pxCoro->ucBlock = coroBLOCK_NONE;
+        pxCoro->pxFunction(pxCoro);
+      }
+
+      if (pxCoro->ucBlock == coroBLOCK_DONE) {
+        prvUnlink(pxCoro, pxPrev);
+        pxCoro = pxCoro->pxNext;
+        continue;
+      }
+
+      xTicks = prvTicksToWait(pxCoro);
+      if (xTicks < xSleep) {
+        xSleep = xTicks;
+      }
+      pxPrev = pxCoro;
+      pxCoro = pxCoro->pxNext;
+    }
+
+    if ((xSleep != 0) && (xRescan == pdFALSE)) {
+      ulTaskNotifyTakeIndexed(configCORO_NOTIFY_INDEX, pdTRUE, xSleep);
+    }
+  }
+
+  xExecutor = NULL;
+}
@@ -0,0 +1,186 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Stackless coroutines
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Any number of cooperative coroutines run inside a single FreeRTOS task
+ * (vCoroRun()). A coroutine is a function that is called again and again by
+ * the executor; the coro*() macros save a resume point (the source line) in
+ * the coroutine's control block and return to the executor when it has to
+ * wait. There is no stack per coroutine: a Coro_t takes a few tens of bytes
+ * instead of a TCB plus a task stack.
+ *
+ * A coroutine can wait for
+ *
+ * - a delay (coroDELAY())
+ * - event bits set by another coroutine, a task or an interrupt handler
+ *   (coroWAIT_EVENTS(), vCoroNotify(), vCoroNotifyFromISR())
+ * - a FIRQ / software interrupt channel (xCoroAttachIrq(), coroEVENT_IRQ)
+ * - data in / space in a queue (coroQUEUE_RECEIVE(), coroQUEUE_SEND())
+ *
+ * all with a timeout in ticks (portMAX_DELAY = forever). The executor task
+ * blocks on a direct-to-task notification (configCORO_NOTIFY_INDEX) while
+ * no coroutine is ready, so it does not wake up for nothing (tickless idle).
+ *
+ * Queues are not able to notify the executor by themselves. Tasks and
+ * interrupt handlers that share a queue with coroutines use the xCoroQueue*()
+ * wrappers, which wake the executor after a successful send / receive. If
+ * configCORO_POLL_TICKS is not 0, coroutines waiting for a queue are also
+ * polled at that period (for queues accessed with the plain queue API).
+ *
+ * Rules (the usual ones for stackless coroutines):
+ *
+ * - local variables do not survive a coro*() macro; keep state in the
+ *   coroutine's context (pvContext) or in static variables
+ * - the body is enclosed by coroBEGIN() / coroEND() and must not use
+ *   switch statements around coro*() macros
+ * - a coroutine must not block the executor task (no blocking kernel calls)
+ *
+ * Example:
+ *
+ *   static void prvBlink(Coro_t *pxCoro) {
+ *     coroBEGIN(pxCoro);
+ *     for (;;) {
+ *       neorv32_gpio_pin_toggle(0);
+ *       coroDELAY(pxCoro, pdMS_TO_TICKS(500));
+ *     }
+ *     coroEND(pxCoro);
+ *   }
+ *
+ *   vCoroCreate(&xBlink, prvBlink, NULL);
+ *   vCoroRun(); // in a task
+ ******************************************************************************/
+
+#ifndef CORO_H
+#define CORO_H
+
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+
+/* Event bit set by interrupt channels attached with xCoroAttachIrq() */
+#define coroEVENT_IRQ                   ( 0x80000000u )
+
+/* What a coroutine waits for */
+#define coroBLOCK_NONE                  ( 0 ) // ready
+#define coroBLOCK_DELAY                 ( 1 )
+#define coroBLOCK_EVENTS                ( 2 )
+#define coroBLOCK_QUEUE_RX              ( 3 )
+#define coroBLOCK_QUEUE_TX              ( 4 )
+#define coroBLOCK_DONE                  ( 5 ) // finished
+
+typedef struct Coro Coro_t;
+
+/* Coroutine function; called with its control block */
+typedef void (*CoroFunction_t)(Coro_t *pxCoro);
+
+/* Coroutine control block */
+struct Coro {
+  struct Coro *pxNext;           // next coroutine of the executor
+  CoroFunction_t pxFunction;
+  void *pvContext;
+  uint32_t ulResume;             // resume point (source line, 0 = start)
+  uint8_t ucBlock;               // coroBLOCK_*
+  volatile uint32_t ulEvents;    // pending event bits
+  uint32_t ulWaitMask;           // event bits waited for
+  QueueHandle_t xQueue;          // queue waited for
+  TickType_t xWaitStart;         // tick count at the start of the wait
+  TickType_t xWaitTicks;         // timeout (portMAX_DELAY = none)
+};
+
+void vCoroCreate(Coro_t *pxCoro, CoroFunction_t pxFunction, void *pvContext);
+void vCoroRun(void);
+void vCoroNotify(Coro_t *pxCoro, uint32_t ulBits);
+void vCoroNotifyFromISR(Coro_t *pxCoro, uint32_t ulBits, BaseType_t *pxHigherPriorityTaskWoken);
+BaseType_t xCoroAttachIrq(uint32_t ulChannel, Coro_t *pxCoro);
+uint32_t ulCoroTakeEvents(Coro_t *pxCoro, uint32_t ulMask);
+BaseType_t xCoroTimedOut(const Coro_t *pxCoro);
+BaseType_t xCoroQueueSend(QueueHandle_t xQueue, const void *pvItem, TickType_t xTicksToWait);
+BaseType_t xCoroQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait);
+BaseType_t xCoroQueueSendFromISR(QueueHandle_t xQueue, const void *pvItem, BaseType_t *pxHigherPriorityTaskWoken);
+BaseType_t xCoroQueueReceiveFromISR(QueueHandle_t xQueue, void *pvBuffer, BaseType_t *pxHigherPriorityTaskWoken);
+
+
+/******************************************************************************
+ * Start a wait (used by the macros below).
+ ******************************************************************************/
+static inline void vCoroStartWait(Coro_t *pxCoro, TickType_t xTicksToWait) {
+
+  pxCoro->xWaitStart = xTaskGetTickCount();
+  pxCoro->xWaitTicks = xTicksToWait;
+}
+
+
+/* Coroutine body */
+#define coroBEGIN( pxCoro )             switch( ( pxCoro )->ulResume ) { case 0:
+#define coroEND( pxCoro )               } ( pxCoro )->ucBlock = coroBLOCK_DONE; return
+
+/* Let the other coroutines run */
+#define coroYIELD( pxCoro )                                                   \
+  do {                                                                        \
+    ( pxCoro )->ulResume = __LINE__;                                          \
+    return;                                                                   \
+    case __LINE__:;                                                           \
+  } while( 0 )
+
+/* Wait for xTicks ticks */
+#define coroDELAY( pxCoro, xTicks )                                           \
+  do {                                                                        \
+    vCoroStartWait( ( pxCoro ), ( xTicks ) );                                 \
+    ( pxCoro )->ulResume = __LINE__;                                          \
+    case __LINE__:                                                            \
+    if( xCoroTimedOut( pxCoro ) == pdFALSE ) {                                \
+      ( pxCoro )->ucBlock = coroBLOCK_DELAY;                                  \
+      return;                                                                 \
+    }                                                                         \
+  } while( 0 )
+
+/* Wait for any of the event bits ulMask; ulEventsOut receives (and clears)
+ * the pending bits of ulMask, 0 on timeout */
+#define coroWAIT_EVENTS( pxCoro, ulMask, xTicksToWait, ulEventsOut )          \
+  do {                                                                        \
+    vCoroStartWait( ( pxCoro ), ( xTicksToWait ) );                           \
+    ( pxCoro )->ulWaitMask = ( ulMask );                                      \
+    ( pxCoro )->ulResume = __LINE__;                                          \
+    case __LINE__:                                                            \
+    ( ulEventsOut ) = ulCoroTakeEvents( ( pxCoro ), ( pxCoro )->ulWaitMask ); \
+    if( ( ( ulEventsOut ) == 0 ) && ( xCoroTimedOut( pxCoro ) == pdFALSE ) ) { \
+      ( pxCoro )->ucBlock = coroBLOCK_EVENTS;                                 \
+      return;                                                                 \
+    }                                                                         \
+  } while( 0 )
+
+/* Receive an item from a queue; xResult is pdPASS or errQUEUE_EMPTY (timeout).
+ * Arguments are evaluated again on every resume. */
+#define coroQUEUE_RECEIVE( pxCoro, xQueueHandle, pvBuffer, xTicksToWait, xResult ) \
+  do {                                                                        \
+    vCoroStartWait( ( pxCoro ), ( xTicksToWait ) );                           \
+    ( pxCoro )->xQueue = ( xQueueHandle );                                    \
+    ( pxCoro )->ulResume = __LINE__;                                          \
+    case __LINE__:                                                            \
+    ( xResult ) = xCoroQueueReceive( ( pxCoro )->xQueue, ( pvBuffer ), 0 );   \
+    if( ( ( xResult ) != pdPASS ) && ( xCoroTimedOut( pxCoro ) == pdFALSE ) ) { \
+      ( pxCoro )->ucBlock = coroBLOCK_QUEUE_RX;                               \
+      return;                                                                 \
+    }                                                                         \
+  } while( 0 )
+
+/* Send an item to a queue; xResult is pdPASS or errQUEUE_FULL (timeout).
+ * Arguments are evaluated again on every resume. */
+#define coroQUEUE_SEND( pxCoro, xQueueHandle, pvItem, xTicksToWait, xResult ) \
+  do {                                                                        \
+    vCoroStartWait( ( pxCoro ), ( xTicksToWait ) );                           \
+    ( pxCoro )->xQueue = ( xQueueHandle );                                    \
+    ( pxCoro )->ulResume = __LINE__;                                          \
+    case __LINE__:                                                            \
+    ( xResult ) = xCoroQueueSend( ( pxCoro )->xQueue, ( pvItem ), 0 );        \
+    if( ( ( xResult ) != pdPASS ) && ( xCoroTimedOut( pxCoro ) == pdFALSE ) ) { \
+      ( pxCoro )->ucBlock = coroBLOCK_QUEUE_TX;                               \
+      return;                                                                 \
+    }                                                                         \
+  } while( 0 )
+
+#endif /* CORO_H */
@@ -0,0 +1,253 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * DMA controller driver
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* DMA driver, FIRQ dispatcher and cache maintenance */
+#include "dma.h"
+#include "irq.h"
+#include "irq_mask.h"
+#include "cache.h"
+
+/* Prototypes */
+static void prvStartNext(void);
+static void prvDmaIrqHandler(void *pvContext);
+
+/* Transfer queue; the first entry is the active one */
+static DmaTransfer_t *pxQueueHead = NULL;
+static DmaTransfer_t *pxQueueTail = NULL;
+
+/* DMA controller available and set up? */
+static BaseType_t xDmaRunning = pdFALSE;
+
+/* Number of completed transfers */
+static volatile uint32_t ulCompleted = 0;
+
+
+/******************************************************************************
+ * Start the first queued transfer (interrupts masked, DMA idle).
+ ******************************************************************************/
+configFAST_TEXT static void prvStartNext(void) {
+
+  DmaTransfer_t *pxTransfer = pxQueueHead;
+  uint32_t ulBytes;
+
+  if (pxTransfer == NULL) {
+    return;
+  }
+
+  // write back the source data; source elements are bytes except for word-to-word transfers
+  ulBytes = pxTransfer->ulCount;
+  if ((pxTransfer->ulCommand & DMA_CMD_W2W) == DMA_CMD_W2W) {
+    ulBytes *= sizeof(uint32_t);
+  }
+  vCacheCleanRange((const void *)pxTransfer->ulSource, ulBytes);
+
+  pxTransfer->eState = eDmaActive;
+  neorv32_dma_transfer(pxTransfer->ulSource, pxTransfer->ulDestination, pxTransfer->ulCount, pxTransfer->ulCommand);
+}
+
+
+/******************************************************************************
+ * DMA completion interrupt: complete the active transfer and start the next
+ * one. Interrupts are only masked while the transfer queue is updated
+ * (nested handlers may submit transfers); cache maintenance and the
+ * completion callback run with interrupts enabled.
+ ******************************************************************************/
+configFAST_TEXT static void prvDmaIrqHandler(void *pvContext) {
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  uint32_t ulStatus = ulIrqMaskSave();
+  DmaTransfer_t *pxTransfer = pxQueueHead;
+  int iStatus = neorv32_dma_status();
+  uint32_t ulBytes;
+
+  (void)pvContext;
+
+  neorv32_dma_irq_ack();
+  if ((pxTransfer == NULL) || (iStatus == DMA_STATUS_BUSY)) {
+    vIrqMaskRestore(ulStatus);
+    return; // spurious
+  }
+
+  // dequeue and keep the DMA busy
+  pxQueueHead = pxTransfer->pxNext;
+  if (pxQueueHead == NULL) {
+    pxQueueTail = NULL;
+  }
+  prvStartNext();
+  vIrqMaskRestore(ulStatus);
+
+  // make the DMA's writes visible to the CPU; destination elements are bytes for byte-to-byte transfers only
+  ulBytes = pxTransfer->ulCount;
+  if ((pxTransfer->ulCommand & DMA_CMD_W2W) != DMA_CMD_B2B) {
+    ulBytes *= sizeof(uint32_t);
+  }
+  vCacheInvalidateRange((void *)pxTransfer->ulDestination, ulBytes);
+
+  ulCompleted++;
+  pxTransfer->eState = (iStatus < 0) ? eDmaError : eDmaDone;
+  if (pxTransfer->pxCallback != NULL) {
+    pxTransfer->pxCallback(pxTransfer->pvContext);
+  }
+  else if (pxTransfer->xTask != NULL) {
+    vTaskNotifyGiveIndexedFromISR(pxTransfer->xTask, configDMA_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+  }
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+
+/******************************************************************************
+ * Enable the DMA controller and install its interrupt handler. Returns
+ * pdFAIL if there is no DMA controller.
+ ******************************************************************************/
+BaseType_t xDmaInit(void) {
+
+  if (neorv32_dma_available() == 0) {
+    return pdFAIL;
+  }
+
+  neorv32_dma_enable();
+  xNeorv32IrqAttach(neorv32IRQ_CHANNEL(DMA_TRAP_CODE), prvDmaIrqHandler, NULL);
+  xDmaRunning = pdTRUE;
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Set up a transfer descriptor (completion notifies the submitting task).
+ ******************************************************************************/
+void vDmaPrepare(DmaTransfer_t *pxTransfer, const volatile void *pvSource, volatile void *pvDestination,
+                 uint32_t ulCount, uint32_t ulCommand) {
+
+  pxTransfer->pxNext = NULL;
+  pxTransfer->ulSource = (uint32_t)pvSource;
+  pxTransfer->ulDestination = (uint32_t)pvDestination;
+  pxTransfer->ulCount = ulCount;
+  pxTransfer->ulCommand = ulCommand;
+  pxTransfer->xTask = NULL;
+  pxTransfer->pxCallback = NULL;
+  pxTransfer->pvContext = NULL;
+  pxTransfer->eState = eDmaIdle;
+}
+
+
+/******************************************************************************
+ * Call pxCallback in interrupt context on completion instead of notifying
+ * the submitting task.
+ ******************************************************************************/
+void vDmaSetCallback(DmaTransfer_t *pxTransfer, DmaCallback_t pxCallback, void *pvContext) {
+
+  pxTransfer->pxCallback = pxCallback;
+  pxTransfer->pvContext = pvContext;
+}
+
+
+/******************************************************************************
+ * Queue a transfer; it is started right away if the DMA is idle. Can be
+ * called from tasks and interrupt handlers (callback transfers only).
+ * Returns pdFAIL if there is no DMA controller or the descriptor is still in
+ * use.
+ ******************************************************************************/
+configFAST_TEXT BaseType_t xDmaSubmit(DmaTransfer_t *pxTransfer) {
+
+  uint32_t ulStatus;
+
+  if ((xDmaRunning == pdFALSE) || (pxTransfer->eState == eDmaPending) || (pxTransfer->eState == eDmaActive)) {
+    return pdFAIL;
+  }
+
+  if (pxTransfer->pxCallback == NULL) {
+    pxTransfer->xTask = xTaskGetCurrentTaskHandle();
+  }
+  pxTransfer->pxNext = NULL;
+  pxTransfer->eState = eDmaPending;
+
+  ulStatus = ulIrqMaskSave();
+  if (pxQueueTail == NULL) {
+    pxQueueHead = pxTransfer;
+    pxQueueTail = pxTransfer;
+    prvStartNext();
+  }
+  else {
+    pxQueueTail->pxNext = pxTransfer;
+    pxQueueTail = pxTransfer;
+  }
+  vIrqMaskRestore(ulStatus);
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Block until a (task-notifying) transfer has completed. Returns pdPASS if
+ * it completed successfully, pdFAIL on a bus error or timeout (on timeout
+ * the descriptor is still owned by the driver).
+ ******************************************************************************/
+BaseType_t xDmaWait(DmaTransfer_t *pxTransfer, TickType_t xTicksToWait) {
+
+  TimeOut_t xTimeOut;
+
+  vTaskSetTimeOutState(&xTimeOut);
+  while ((pxTransfer->eState == eDmaPending) || (pxTransfer->eState == eDmaActive)) {
+    // every completion of one of this task's transfers gives one notification
+    if ((xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE) ||
+        (ulTaskNotifyTakeIndexed(configDMA_NOTIFY_INDEX, pdFALSE, xTicksToWait) == 0)) {
+      return ((pxTransfer->eState == eDmaDone) ? pdPASS : pdFAIL);
+    }
+  }
+  return ((pxTransfer->eState == eDmaDone) ? pdPASS : pdFAIL);
+}
+
+
+/******************************************************************************
+ * Copy a memory block using the DMA and block until done (word transfers if
+ * both buffers and the size are word-aligned, byte transfers otherwise).
+ * Returns pdFAIL if there is no DMA controller or on a bus error.
+ ******************************************************************************/
+BaseType_t xDmaMemcpy(void *pvDestination, const void *pvSource, size_t xBytes) {
+
+  DmaTransfer_t xTransfer;
+
+  if ((((uint32_t)pvDestination | (uint32_t)pvSource | (uint32_t)xBytes) & 3u) == 0) {
+    vDmaPrepare(&xTransfer, pvSource, pvDestination, xBytes / sizeof(uint32_t),
+                DMA_CMD_W2W | DMA_CMD_SRC_INC | DMA_CMD_DST_INC);
+  }
+  else {
+    vDmaPrepare(&xTransfer, pvSource, pvDestination, xBytes, DMA_CMD_B2B | DMA_CMD_SRC_INC | DMA_CMD_DST_INC);
+  }
+
+  if (xDmaSubmit(&xTransfer) != pdPASS) {
+    return pdFAIL;
+  }
+  return xDmaWait(&xTransfer, portMAX_DELAY);
+}
+
+
+/******************************************************************************
+ * Check if the DMA controller is available and set up (xDmaInit()).
+ ******************************************************************************/
+BaseType_t xDmaIsAvailable(void) {
+
+  return xDmaRunning;
+}
+
+
+/******************************************************************************
+ * Get the number of completed transfers.
+ ******************************************************************************/
+uint32_t ulDmaGetCompleted(void) {
+
+  return ulCompleted;
+}
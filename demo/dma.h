@@ -0,0 +1,73 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * DMA controller driver
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Transfers are described by DmaTransfer_t descriptors that are queued by
+ * xDmaSubmit() and executed one after the other by the DMA controller. The
+ * DMA completion interrupt (FIRQ, see irq.c) starts the next queued transfer
+ * and notifies the submitting task (notification index
+ * configDMA_NOTIFY_INDEX), which can block in xDmaWait() meanwhile - the CPU
+ * is free for other tasks during the transfer. Alternatively, a callback is
+ * called in interrupt context (vDmaSetCallback()).
+ *
+ * The data cache is cleaned before a transfer is started and invalidated
+ * after it completed (cache.h).
+ *
+ * ulCommand uses the HAL's DMA_CMD_* flags: data quantity (e.g. DMA_CMD_B2B,
+ * DMA_CMD_W2W) and source/destination addressing (DMA_CMD_SRC_INC /
+ * DMA_CMD_SRC_CONST, DMA_CMD_DST_INC / DMA_CMD_DST_CONST); ulCount is the
+ * number of source elements. The DMA has no flow control for peripherals:
+ * transfers to or from a peripheral data register (constant address) must
+ * not exceed the peripheral's FIFO depth.
+ *
+ * Descriptors are owned by the driver from xDmaSubmit() until the transfer
+ * has completed; they must not be modified or go out of scope before.
+ ******************************************************************************/
+
+#ifndef DMA_H
+#define DMA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Transfer state */
+typedef enum {
+  eDmaIdle = 0, // not submitted yet
+  eDmaPending,  // queued
+  eDmaActive,   // executed by the DMA controller
+  eDmaDone,     // completed successfully
+  eDmaError     // bus error
+} DmaState_t;
+
+/* Completion callback; called in interrupt context */
+typedef void (*DmaCallback_t)(void *pvContext);
+
+/* Transfer descriptor */
+typedef struct DmaTransfer {
+  struct DmaTransfer *pxNext;
+  uint32_t ulSource;
+  uint32_t ulDestination;
+  uint32_t ulCount;
+  uint32_t ulCommand;
+  TaskHandle_t xTask;            // notified on completion (if there is no callback)
+  DmaCallback_t pxCallback;
+  void *pvContext;
+  volatile DmaState_t eState;
+} DmaTransfer_t;
+
+BaseType_t xDmaInit(void);
+void vDmaPrepare(DmaTransfer_t *pxTransfer, const volatile void *pvSource, volatile void *pvDestination,
+                 uint32_t ulCount, uint32_t ulCommand);
+void vDmaSetCallback(DmaTransfer_t *pxTransfer, DmaCallback_t pxCallback, void *pvContext);
+BaseType_t xDmaSubmit(DmaTransfer_t *pxTransfer);
+BaseType_t xDmaWait(DmaTransfer_t *pxTransfer, TickType_t xTicksToWait);
+BaseType_t xDmaMemcpy(void *pvDestination, const void *pvSource, size_t xBytes);
+BaseType_t xDmaIsAvailable(void);
+uint32_t ulDmaGetCompleted(void);
+
+#endif /* DMA_H */
@@ -43,12 +43,28 @@
 
 /*
  * NEORV32 chip-specific extensions
+ *
+ * The NEORV32 does not implement any additional (non-standard) registers that
+ * would have to be part of a task's context. The size of the standard context
+ * is selected by the generic port (portContext.h) depending on the ISA: only
+ * x1..x15 are saved/restored for RV32E (__riscv_32e, PROFILE=rv32emc*), which
+ * halves the context frame from 31 to 15 words (+ mepc/mstatus/nesting).
+ *
+ * The PMP stack guard (stack_guard.c, configUSE_PMP_STACK_GUARD) does not
+ * need additional context either: its per-task state is mstatus.MPRV, which
+ * is part of the saved mstatus, and the guard region is reprogrammed from
+ * the TCB's stack base on every task switch.
+ *
+ * The MTIME tick is not handled by the port (portasmHAS_MTIME = 0): the tick
+ * increment depends on the clock detected at run time, so the timer
+ * interrupt is passed to freertos_risc_v_application_interrupt_handler()
+ * and handled by tick.c.
  */
 
 #ifndef __FREERTOS_RISC_V_EXTENSIONS_H__
 #define __FREERTOS_RISC_V_EXTENSIONS_H__
 
-#define portasmHAS_MTIME               ( 1 )
+#define portasmHAS_MTIME               ( 0 )
 #define portasmADDITIONAL_CONTEXT_SIZE ( 0 )
 
 .macro portasmSAVE_ADDITIONAL_REGISTERS
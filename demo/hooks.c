@@ -0,0 +1,200 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * FreeRTOS hooks and platform functions
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Shared by the target build and the host build (host/makefile), so both run
+ * the same hook code. Only the final stop after a fault differs: vFaultHalt()
+ * is provided by main.c (halts the CPU) and host/main.c (aborts the program).
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Console */
+#include "console.h"
+
+/* External definitions */
+extern void vFaultHalt(void); // stop after a fatal error (main.c, host/main.c); does not return
+
+/* Prototypes for the standard FreeRTOS callback/hook functions implemented
+ * within this file. See https://www.freertos.org/a00016.html */
+void vApplicationMallocFailedHook(void);
+void vApplicationIdleHook(void);
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName);
+void vApplicationTickHook(void);
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, configSTACK_DEPTH_TYPE *puxIdleTaskStackSize);
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, configSTACK_DEPTH_TYPE *puxTimerTaskStackSize);
+#if ( configNUMBER_OF_CORES > 1 )
+void vApplicationGetPassiveIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, configSTACK_DEPTH_TYPE *puxIdleTaskStackSize, BaseType_t xPassiveIdleTaskIndex);
+#endif
+#endif
+
+/* Platform-specific prototypes */
+void vToggleLED(void);
+void vSendString(const char * pcString);
+
+
+/******************************************************************************
+ * Toggle GPIO.out(0) pin.
+ ******************************************************************************/
+void vToggleLED(void) {
+
+  neorv32_gpio_pin_toggle(0);
+}
+
+
+/******************************************************************************
+ * Send a plain string via UART0 (non-blocking, see console.c).
+ ******************************************************************************/
+void vSendString(const char * pcString) {
+
+  vConsolePuts(pcString);
+}
+
+
+//#################################################################################################
+// FreeRTOS Hooks
+//#################################################################################################
+
+/******************************************************************************
+ * Hook for failing malloc.
+ ******************************************************************************/
+void vApplicationMallocFailedHook(void) {
+
+	/* vApplicationMallocFailedHook() will only be called if
+	configUSE_MALLOC_FAILED_HOOK is set to 1 in FreeRTOSConfig.h. It is a hook
+	function that will get called if a call to pvPortMalloc() fails.
+	pvPortMalloc() is called internally by the kernel whenever a task, queue,
+	timer or semaphore is created. It is also called by various parts of the
+	demo application. The size of the heap available to pvPortMalloc() is
+	defined by configTOTAL_HEAP_SIZE in FreeRTOSConfig.h. The
+	xPortGetFreeHeapSize() API function can be used to query the size of free
+	heap space that remains (although it does not provide information on how
+	the remaining heap might be fragmented).
+
+	If heap_3.c is used, then configTOTAL_HEAP_SIZE has no effect and the heap
+	size is instead defined by setting the linker variable __neorv32_heap_size.
+	xPortGetFreeHeapSize() cannot be used with heap_3.c. */
+
+	taskDISABLE_INTERRUPTS();
+
+  vConsolePanicPuts("FreeRTOS_FAULT: vApplicationMallocFailedHook "
+                    "(increase 'configTOTAL_HEAP_SIZE' in FreeRTOSConfig.h)\n");
+
+  vFaultHalt();
+}
+
+
+/******************************************************************************
+ * Hook for the idle process.
+ ******************************************************************************/
+void vApplicationIdleHook(void) {
+
+	/* vApplicationIdleHook() will only be called if configUSE_IDLE_HOOK is set
+	to 1 in FreeRTOSConfig.h. It will be called on each iteration of the idle
+	task. It is essential that code added to this hook function never attempts
+	to block in any way (for example, call xQueueReceive() with a block time
+	specified, or call vTaskDelay()). If the application makes use of the
+	vTaskDelete() API function (as this demo application does) then it is also
+	important that vApplicationIdleHook() is permitted to return to its calling
+	function, because it is the responsibility of the idle task to clean up
+	memory allocated by the kernel to any task that has since been deleted. */
+
+#if ( configUSE_TICKLESS_IDLE == 0 )
+  neorv32_cpu_sleep(); // cpu wakes up on any interrupt request (host: gives the host CPU back for a moment)
+#endif
+  // with tickless idle the CPU is put to sleep by vPortSuppressTicksAndSleep()
+}
+
+
+/******************************************************************************
+ * Hook for task stack overflow.
+ ******************************************************************************/
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+
+	(void)pxTask;
+
+	/* Run time stack overflow checking is performed if
+	configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2. This hook
+	function is called if a stack overflow is detected. */
+
+	taskDISABLE_INTERRUPTS();
+
+  vConsolePanicPuts("FreeRTOS_FAULT: vApplicationStackOverflowHook in task ");
+  vConsolePanicPuts(pcTaskName);
+  vConsolePanicPuts(" (increase its stack size, see tools/stack_report.py)\n");
+
+  vFaultHalt();
+}
+
+
+/******************************************************************************
+ * Hook for the application tick (unused).
+ ******************************************************************************/
+void vApplicationTickHook(void) {
+
+  __asm volatile( "nop" ); // nothing to do here yet
+}
+
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+/******************************************************************************
+ * Provide the memory for the idle task (static allocation only).
+ ******************************************************************************/
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   configSTACK_DEPTH_TYPE *puxIdleTaskStackSize) {
+
+  static StaticTask_t xIdleTaskTCB configSTATIC_DATA;
+  static StackType_t xIdleTaskStack[configMINIMAL_STACK_SIZE] configSTATIC_DATA;
+
+  *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+  *ppxIdleTaskStackBuffer = xIdleTaskStack;
+  *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+
+/******************************************************************************
+ * Provide the memory for the timer service task (static allocation only).
+ ******************************************************************************/
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    configSTACK_DEPTH_TYPE *puxTimerTaskStackSize) {
+
+  static StaticTask_t xTimerTaskTCB configSTATIC_DATA;
+  static StackType_t xTimerTaskStack[configTIMER_TASK_STACK_DEPTH] configSTATIC_DATA;
+
+  *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+  *ppxTimerTaskStackBuffer = xTimerTaskStack;
+  *puxTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+
+#if ( configNUMBER_OF_CORES > 1 )
+/******************************************************************************
+ * Provide the memory for the passive idle tasks of the other harts (static
+ * allocation and SMP only).
+ ******************************************************************************/
+void vApplicationGetPassiveIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                          StackType_t **ppxIdleTaskStackBuffer,
+                                          configSTACK_DEPTH_TYPE *puxIdleTaskStackSize,
+                                          BaseType_t xPassiveIdleTaskIndex) {
+
+  static StaticTask_t xIdleTaskTCBs[configNUMBER_OF_CORES - 1] configSTATIC_DATA;
+  static StackType_t xIdleTaskStacks[configNUMBER_OF_CORES - 1][configMINIMAL_STACK_SIZE] configSTATIC_DATA;
+
+  *ppxIdleTaskTCBBuffer = &xIdleTaskTCBs[xPassiveIdleTaskIndex];
+  *ppxIdleTaskStackBuffer = xIdleTaskStacks[xPassiveIdleTaskIndex];
+  *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+#endif
+#endif
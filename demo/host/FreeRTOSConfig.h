@@ -0,0 +1,107 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Host build - FreeRTOS configuration for the POSIX port
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Mirrors the application-visible parts of ../FreeRTOSConfig.h (priorities,
+ * tick rate, clock, allocation). Values that only make sense on the host
+ * (stack sizes: every task is a pthread, heap: malloc) differ.
+ ******************************************************************************/
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/* NEORV32 HAL shim */
+#include <neorv32.h>
+
+#define configUSE_PREEMPTION                    ( 1 )
+#define configUSE_IDLE_HOOK                     ( 1 )
+#define configUSE_TICK_HOOK                     ( 1 )
+#define configCPU_CLOCK_HZ                      ( 100000000 )
+#define configTICK_RATE_HZ                      ( (TickType_t)(100) )
+#define configMAX_PRIORITIES                    ( 5 )
+#define configMINIMAL_STACK_SIZE                ( (unsigned short)(8192) ) // words; >= 2 * PTHREAD_STACK_MIN
+#define configTOTAL_HEAP_SIZE                   ( (size_t)(1024 * 1024) ) // unused: heap_3 (malloc)
+#define configSTACK_DEPTH_TYPE                  uint32_t
+#define configMAX_TASK_NAME_LEN                 ( 16 )
+#define configUSE_TRACE_FACILITY                ( 1 )
+#define configUSE_16_BIT_TICKS                  ( 0 )
+#define configIDLE_SHOULD_YIELD                 ( 0 )
+#define configUSE_MUTEXES                       ( 1 )
+#define configQUEUE_REGISTRY_SIZE               ( 8 )
+#define configUSE_RECURSIVE_MUTEXES             ( 1 )
+#define configUSE_MALLOC_FAILED_HOOK            ( 1 )
+#define configUSE_APPLICATION_TASK_TAG          ( 0 )
+#define configUSE_COUNTING_SEMAPHORES           ( 1 )
+#define configGENERATE_RUN_TIME_STATS           ( 0 )
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION ( 0 )
+#define configUSE_QUEUE_SETS                    ( 1 )
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   ( 6 )
+#define configUSE_TICKLESS_IDLE                 ( 0 )
+#define configNUMBER_OF_CORES                   ( 1 )
+#define configCHECK_FOR_STACK_OVERFLOW          ( 2 )
+
+/* Kernel object allocation: dynamic (heap_3, default) or static ("make ALLOCATION=static") */
+#ifndef configSUPPORT_STATIC_ALLOCATION
+  #define configSUPPORT_STATIC_ALLOCATION       ( 0 )
+#endif
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  #define configSUPPORT_DYNAMIC_ALLOCATION      ( 0 )
+#else
+  #define configSUPPORT_DYNAMIC_ALLOCATION      ( 1 )
+#endif
+
+/* Section attributes of the target build have no meaning on the host */
+#define configSTATIC_DATA                       __attribute__((aligned(16)))
+#define configSCRATCHPAD_DATA
+#define configFAST_TEXT
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES                   ( 0 )
+#define configMAX_CO_ROUTINE_PRIORITIES         ( 2 )
+
+/* Software timer definitions. */
+#define configUSE_TIMERS                        ( 1 )
+#define configTIMER_TASK_PRIORITY               ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH                ( 8 )
+#define configTIMER_TASK_STACK_DEPTH            ( configMINIMAL_STACK_SIZE )
+
+/* Notification indices (see ../FreeRTOSConfig.h) */
+#define configCONSOLE_PRINTF_BUFFER_SIZE        ( 96 )
+#define configCONSOLE_NOTIFY_INDEX              ( 1 )
+#define configIRQ_NOTIFY_INDEX                  ( 2 )
+#define configCHANNEL_NOTIFY_INDEX              ( 3 )
+#define configHRTIMER_NOTIFY_INDEX              ( 4 )
+#define configDMA_NOTIFY_INDEX                  ( 5 )
+
+/* Stop the demo after this many milliseconds (exit code 0, "make RUN_TIME=..."); 0 = run forever */
+#ifndef configHOST_RUN_TIME_MS
+  #define configHOST_RUN_TIME_MS                ( 0 )
+#endif
+
+/* Set the following definitions to 1 to include the API function, or zero to exclude the API function. */
+#define INCLUDE_vTaskPrioritySet                ( 1 )
+#define INCLUDE_uxTaskPriorityGet               ( 1 )
+#define INCLUDE_vTaskDelete                     ( 1 )
+#define INCLUDE_vTaskCleanUpResources           ( 1 )
+#define INCLUDE_vTaskSuspend                    ( 1 )
+#define INCLUDE_vTaskDelayUntil                 ( 1 )
+#define INCLUDE_vTaskDelay                      ( 1 )
+#define INCLUDE_eTaskGetState                   ( 1 )
+#define INCLUDE_xTimerPendFunctionCall          ( 1 )
+#define INCLUDE_xTaskAbortDelay                 ( 1 )
+#define INCLUDE_xTaskGetHandle                  ( 1 )
+#define INCLUDE_xSemaphoreGetMutexHolder        ( 1 )
+#define INCLUDE_xTaskGetSchedulerState          ( 1 )
+#define INCLUDE_xTaskGetCurrentTaskHandle       ( 1 )
+#define INCLUDE_xTaskGetIdleTaskHandle          ( 1 )
+
+/* Normal assert() semantics without relying on the provision of an assert.h header file. */
+void vAssertCalled( const char * pcFile, unsigned long ulLine );
+#define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+
+/* Map to the platform's write function. */
+void vSendString( const char * pcString );
+#define configPRINT_STRING( pcString )          vSendString( pcString )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Host build - console (console.h API on the UART0 shim)
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * The host has no UART interrupts, so all output is written right away and
+ * never dropped; there is no console input.
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL shim */
+#include <neorv32.h>
+
+/* Console API */
+#include "console.h"
+
+
+/******************************************************************************
+ * Setup UART0.
+ ******************************************************************************/
+void vConsoleInit(uint32_t ulBaudRate) {
+
+  neorv32_uart_setup(NEORV32_UART0, ulBaudRate, 0);
+}
+
+
+/******************************************************************************
+ * Output.
+ ******************************************************************************/
+void vConsolePuts(const char *pcString) {
+
+  neorv32_uart_puts(NEORV32_UART0, pcString);
+}
+
+void vConsolePrintf(const char *pcFormat, ...) {
+
+  char cBuffer[configCONSOLE_PRINTF_BUFFER_SIZE];
+  va_list xArgs;
+
+  va_start(xArgs, pcFormat);
+  vsnprintf(cBuffer, sizeof(cBuffer), pcFormat, xArgs);
+  va_end(xArgs);
+  vConsolePuts(cBuffer);
+}
+
+void vConsolePrintfBlocking(const char *pcFormat, ...) {
+
+  char cBuffer[configCONSOLE_PRINTF_BUFFER_SIZE];
+  va_list xArgs;
+
+  va_start(xArgs, pcFormat);
+  vsnprintf(cBuffer, sizeof(cBuffer), pcFormat, xArgs);
+  va_end(xArgs);
+  vConsolePuts(cBuffer);
+}
+
+size_t xConsoleWrite(const char *pcBuffer, size_t xLength, TickType_t xTicksToWait) {
+
+  size_t i;
+
+  (void)xTicksToWait;
+
+  for (i = 0; i < xLength; i++) {
+    neorv32_uart_putc(NEORV32_UART0, pcBuffer[i]);
+  }
+  return xLength;
+}
+
+void vConsoleFlush(void) {
+
+  fflush(stdout);
+}
+
+void vConsolePanicPuts(const char *pcString) {
+
+  vConsolePuts(pcString);
+  vConsoleFlush();
+}
+
+uint32_t ulConsoleGetDropped(void) {
+
+  return 0;
+}
+
+
+/******************************************************************************
+ * Input: there is none; block for the given time and return nothing.
+ ******************************************************************************/
+size_t xConsoleRead(char *pcBuffer, size_t xLength, TickType_t xTicksToWait) {
+
+  (void)pcBuffer;
+  (void)xLength;
+
+  if ((xTicksToWait != 0) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)) {
+    vTaskDelay(xTicksToWait);
+  }
+  return 0;
+}
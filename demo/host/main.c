@@ -0,0 +1,153 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Host build - main and FreeRTOS hooks
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Host counterpart of ../main.c for the FreeRTOS POSIX port. The FreeRTOS
+ * hooks and platform functions (vToggleLED(), vSendString()) are the
+ * target's ones (../hooks.c) on top of the HAL shim (neorv32.h). Faults
+ * print a message and abort() instead of halting, so they end the run with a
+ * failure exit status (and a sanitizer report). The demo's 4-second GPTMR
+ * tick runs on the shim's GPTMR (a POSIX timer).
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <timers.h>
+
+/* NEORV32 HAL shim */
+#include <neorv32.h>
+
+/* Console */
+#include "console.h"
+
+/* Application to run; select via "make APP=..." */
+#ifndef mainAPPLICATION
+  #define mainAPPLICATION blinky
+#endif
+
+/* External definitions */
+extern void mainAPPLICATION(void); // actual show-case application (../blinky.c, ../smp_bench.c)
+
+/* The FreeRTOS hooks, vToggleLED() and vSendString() are the target's ones (../hooks.c) */
+
+/* Platform-specific prototypes */
+void vFaultHalt(void);
+static void prvSetupRunTime(void);
+static void prvRunTimeExpired(TimerHandle_t xTimer);
+static void prvGptmrIrqHandler(void);
+static void prvGptmrTick(void *pvParameter1, uint32_t ulParameter2);
+
+
+/******************************************************************************
+ * Main function (should never return).
+ ******************************************************************************/
+int main(void) {
+
+  // setup "hardware"
+  neorv32_gpio_port_set(0);
+  vConsoleInit(0);
+
+  // say hello
+  vConsolePrintf("\n<<< NEORV32 (host) running FreeRTOS %s >>>\n\n", tskKERNEL_VERSION_NUMBER);
+
+  // demo GPTMR interrupt: fire every 4 seconds (slice 0, continuous mode)
+  if (neorv32_gptmr_available() != 0) {
+    neorv32_host_gptmr_irq_attach(prvGptmrIrqHandler);
+    neorv32_gptmr_setup(0);
+    neorv32_gptmr_configure(0, 0, 4u * configCPU_CLOCK_HZ, 1);
+    neorv32_gptmr_enable_single(0);
+  }
+
+  // end the run after configHOST_RUN_TIME_MS (if set)
+  prvSetupRunTime();
+
+  // run actual application code
+  mainAPPLICATION();
+
+  // we should never reach this
+  vConsolePanicPuts("WARNING! application returned!\n");
+  return -1;
+}
+
+
+/******************************************************************************
+ * Create the timer that ends the run (configHOST_RUN_TIME_MS != 0).
+ ******************************************************************************/
+static void prvSetupRunTime(void) {
+
+#if ( configHOST_RUN_TIME_MS != 0 )
+  TimerHandle_t xTimer;
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  static StaticTimer_t xTimerBuffer;
+  xTimer = xTimerCreateStatic("RunTime", pdMS_TO_TICKS(configHOST_RUN_TIME_MS), pdFALSE, NULL, prvRunTimeExpired,
+                              &xTimerBuffer);
+#else
+  xTimer = xTimerCreate("RunTime", pdMS_TO_TICKS(configHOST_RUN_TIME_MS), pdFALSE, NULL, prvRunTimeExpired);
+#endif
+  configASSERT(xTimer != NULL);
+  xTimerStart(xTimer, 0);
+#endif
+}
+
+
+/******************************************************************************
+ * End of the run: report and exit successfully.
+ ******************************************************************************/
+static void prvRunTimeExpired(TimerHandle_t xTimer) {
+
+  (void)xTimer;
+
+  vConsolePrintf("\n#HOST-END ticks=%u tasks=%u\n", (unsigned)xTaskGetTickCount(),
+                 (unsigned)uxTaskGetNumberOfTasks());
+  vConsoleFlush();
+  exit(0);
+}
+
+
+/******************************************************************************
+ * GPTMR "interrupt" (signal handler, see neorv32_host.c): the output is
+ * deferred to the timer service task as the host console is not
+ * async-signal-safe.
+ ******************************************************************************/
+static void prvGptmrIrqHandler(void) {
+
+  neorv32_gptmr_irq_ack(neorv32_gptmr_irq_get());
+  xTimerPendFunctionCallFromISR(prvGptmrTick, NULL, 0, NULL);
+}
+
+static void prvGptmrTick(void *pvParameter1, uint32_t ulParameter2) {
+
+  (void)pvParameter1;
+  (void)ulParameter2;
+
+  vConsolePuts("GPTMR IRQ Tick\n");
+}
+
+
+/******************************************************************************
+ * Assert terminator.
+ ******************************************************************************/
+void vAssertCalled(const char *pcFile, unsigned long ulLine) {
+
+  taskDISABLE_INTERRUPTS();
+
+  vConsolePrintf("FreeRTOS_FAULT: vAssertCalled called! (%s:%lu)\n", pcFile, ulLine);
+  vConsoleFlush();
+  abort();
+}
+
+
+/******************************************************************************
+ * Stop after a fatal error (FreeRTOS hooks, see ../hooks.c).
+ ******************************************************************************/
+void vFaultHalt(void) {
+
+  abort();
+}
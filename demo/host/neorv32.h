@@ -0,0 +1,84 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Host build - NEORV32 HAL shim
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Provides the subset of the NEORV32 HAL used by the host-buildable parts of
+ * the demo (neorv32_host.c):
+ *
+ *  - UART0:   output goes to stdout, there is no input
+ *  - GPIO:    output port state; every change is logged to stdout as
+ *             "#GPIO:<time_us> 0x<port>"
+ *  - CLINT:   MTIME is the host's monotonic clock scaled to
+ *             configCPU_CLOCK_HZ
+ *  - GPTMR:   neorv32_host_gptmr_slices slices, each backed by a POSIX timer
+ *             (CLOCK_MONOTONIC) counting at configCPU_CLOCK_HZ / prescaler;
+ *             the "interrupt" is a real-time signal that calls the handler
+ *             installed with neorv32_host_gptmr_irq_attach()
+ *  - SYSINFO: CLK = configCPU_CLOCK_HZ, no caches
+ *  - CPU:     mcycle follows MTIME, sleep yields the host CPU for a moment
+ ******************************************************************************/
+
+#ifndef NEORV32_H
+#define NEORV32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* SYSINFO */
+typedef struct {
+  uint32_t CLK;
+  uint8_t  MISC[4];
+  uint32_t SOC;
+  uint32_t CACHE;
+} neorv32_sysinfo_t;
+
+extern neorv32_sysinfo_t neorv32_host_sysinfo;
+#define NEORV32_SYSINFO (&neorv32_host_sysinfo)
+
+enum NEORV32_SYSINFO_SOC_enum {
+  SYSINFO_SOC_ICACHE = 16,
+  SYSINFO_SOC_DCACHE = 17
+};
+
+/* UART */
+typedef struct {
+  uint32_t CTRL;
+  uint32_t DATA;
+} neorv32_uart_t;
+
+extern neorv32_uart_t neorv32_host_uart0;
+#define NEORV32_UART0 (&neorv32_host_uart0)
+
+void neorv32_uart_setup(neorv32_uart_t *UARTx, uint32_t baudrate, uint32_t irq_mask);
+void neorv32_uart_putc(neorv32_uart_t *UARTx, char c);
+void neorv32_uart_puts(neorv32_uart_t *UARTx, const char *s);
+
+/* GPIO */
+void     neorv32_gpio_port_set(uint32_t pin_mask);
+uint32_t neorv32_gpio_port_get(void);
+void     neorv32_gpio_pin_set(int pin, int value);
+void     neorv32_gpio_pin_toggle(int pin);
+
+/* CLINT */
+int      neorv32_clint_available(void);
+uint64_t neorv32_clint_time_get(void);
+
+/* GPTMR */
+#define neorv32_host_gptmr_slices ( 4 )
+
+int      neorv32_gptmr_available(void);
+int      neorv32_gptmr_get_num_slices(void);
+void     neorv32_gptmr_setup(int prsc);
+void     neorv32_gptmr_configure(int slice, uint32_t count, uint32_t thres, int mode);
+void     neorv32_gptmr_enable_single(int slice);
+void     neorv32_gptmr_disable_single(int slice);
+uint32_t neorv32_gptmr_irq_get(void);
+void     neorv32_gptmr_irq_ack(uint32_t mask);
+void     neorv32_host_gptmr_irq_attach(void (*handler)(void));
+
+/* CPU */
+uint64_t neorv32_cpu_get_cycle(void);
+void     neorv32_cpu_sleep(void);
+
+#endif /* NEORV32_H */
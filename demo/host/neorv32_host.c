@@ -0,0 +1,244 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Host build - NEORV32 HAL shim
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stdio.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+
+/* NEORV32 HAL shim */
+#include <neorv32.h>
+
+/* "Hardware" */
+neorv32_sysinfo_t neorv32_host_sysinfo = { .CLK = configCPU_CLOCK_HZ };
+neorv32_uart_t neorv32_host_uart0;
+static volatile uint32_t ulGpioPort = 0;
+
+/* MTIME origin */
+static struct timespec xTimeBase;
+static int iTimeBaseValid = 0;
+
+/* GPTMR: one POSIX timer per slice, pending interrupts, handler */
+static timer_t xGptmrTimer[neorv32_host_gptmr_slices];
+static uint32_t ulGptmrCount[neorv32_host_gptmr_slices];
+static uint32_t ulGptmrThreshold[neorv32_host_gptmr_slices];
+static int iGptmrContinuous[neorv32_host_gptmr_slices];
+static uint32_t ulGptmrDivider = 2;
+static int iGptmrReady = 0;
+static volatile uint32_t ulGptmrPending = 0;
+static void (*volatile pxGptmrHandler)(void) = NULL;
+
+
+/******************************************************************************
+ * UART0: stdout (unbuffered, so the output interleaves correctly with the
+ * GPIO log and survives an abort).
+ ******************************************************************************/
+void neorv32_uart_setup(neorv32_uart_t *UARTx, uint32_t baudrate, uint32_t irq_mask) {
+
+  (void)baudrate;
+  (void)irq_mask;
+
+  UARTx->CTRL = 1;
+  setvbuf(stdout, NULL, _IONBF, 0);
+}
+
+void neorv32_uart_putc(neorv32_uart_t *UARTx, char c) {
+
+  (void)UARTx;
+
+  if (c != '\r') {
+    fputc(c, stdout);
+  }
+}
+
+void neorv32_uart_puts(neorv32_uart_t *UARTx, const char *s) {
+
+  while (*s) {
+    neorv32_uart_putc(UARTx, *s++);
+  }
+}
+
+
+/******************************************************************************
+ * GPIO: log every change of the output port.
+ ******************************************************************************/
+void neorv32_gpio_port_set(uint32_t pin_mask) {
+
+  if (pin_mask != ulGpioPort) {
+    ulGpioPort = pin_mask;
+    printf("#GPIO:%llu 0x%08x\n", (unsigned long long)(neorv32_clint_time_get() / (configCPU_CLOCK_HZ / 1000000)),
+           (unsigned)pin_mask);
+  }
+}
+
+uint32_t neorv32_gpio_port_get(void) {
+
+  return ulGpioPort;
+}
+
+void neorv32_gpio_pin_set(int pin, int value) {
+
+  if (value) {
+    neorv32_gpio_port_set(ulGpioPort | (1u << pin));
+  }
+  else {
+    neorv32_gpio_port_set(ulGpioPort & ~(1u << pin));
+  }
+}
+
+void neorv32_gpio_pin_toggle(int pin) {
+
+  neorv32_gpio_port_set(ulGpioPort ^ (1u << pin));
+}
+
+
+/******************************************************************************
+ * CLINT: MTIME counts at configCPU_CLOCK_HZ from the first access on.
+ ******************************************************************************/
+int neorv32_clint_available(void) {
+
+  return 1;
+}
+
+uint64_t neorv32_clint_time_get(void) {
+
+  struct timespec xNow;
+  uint64_t ullNs;
+
+  clock_gettime(CLOCK_MONOTONIC, &xNow);
+  if (iTimeBaseValid == 0) {
+    xTimeBase = xNow;
+    iTimeBaseValid = 1;
+  }
+
+  ullNs = (uint64_t)(xNow.tv_sec - xTimeBase.tv_sec) * 1000000000ull + (uint64_t)xNow.tv_nsec -
+          (uint64_t)xTimeBase.tv_nsec;
+  return (ullNs * (configCPU_CLOCK_HZ / 1000000)) / 1000;
+}
+
+
+/******************************************************************************
+ * GPTMR: every slice is a POSIX timer that raises SIGRTMIN. The FreeRTOS
+ * POSIX port blocks all signals in critical sections and in every thread but
+ * the one of the running task, so the signal handler behaves like an
+ * interrupt handler (FromISR API only). The prescaler codes are the ones of
+ * the HAL (0 = CLK_PRSC_2, ..., 7 = CLK_PRSC_4096).
+ ******************************************************************************/
+static void prvGptmrSignal(int iSignal, siginfo_t *pxInfo, void *pvContext) {
+
+  (void)iSignal;
+  (void)pvContext;
+
+  __atomic_fetch_or(&ulGptmrPending, 1u << pxInfo->si_value.sival_int, __ATOMIC_SEQ_CST);
+  if (pxGptmrHandler != NULL) {
+    pxGptmrHandler();
+  }
+}
+
+int neorv32_gptmr_available(void) {
+
+  return 1;
+}
+
+int neorv32_gptmr_get_num_slices(void) {
+
+  return neorv32_host_gptmr_slices;
+}
+
+void neorv32_gptmr_setup(int prsc) {
+
+  static const uint32_t ulDividers[8] = { 2, 4, 8, 64, 128, 1024, 2048, 4096 };
+  struct sigaction xAction = { 0 };
+  struct sigevent xEvent = { 0 };
+  int i;
+
+  ulGptmrDivider = ulDividers[prsc & 7];
+  if (iGptmrReady != 0) {
+    return;
+  }
+
+  xAction.sa_sigaction = prvGptmrSignal;
+  xAction.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigfillset(&xAction.sa_mask); // no tick or yield signal while the handler runs
+  sigaction(SIGRTMIN, &xAction, NULL);
+
+  for (i = 0; i < neorv32_host_gptmr_slices; i++) {
+    xEvent.sigev_notify = SIGEV_SIGNAL;
+    xEvent.sigev_signo = SIGRTMIN;
+    xEvent.sigev_value.sival_int = i;
+    timer_create(CLOCK_MONOTONIC, &xEvent, &xGptmrTimer[i]);
+  }
+  iGptmrReady = 1;
+}
+
+void neorv32_gptmr_configure(int slice, uint32_t count, uint32_t thres, int mode) {
+
+  ulGptmrCount[slice] = count;
+  ulGptmrThreshold[slice] = thres;
+  iGptmrContinuous[slice] = mode;
+}
+
+void neorv32_gptmr_enable_single(int slice) {
+
+  struct itimerspec xTime = { 0 };
+  uint64_t ullNs;
+
+  // time until the counter reaches the threshold (continuous mode: then the full period from 0)
+  ullNs = ((uint64_t)(ulGptmrThreshold[slice] - ulGptmrCount[slice]) * ulGptmrDivider * 1000) /
+          (configCPU_CLOCK_HZ / 1000000);
+  xTime.it_value.tv_sec = (time_t)(ullNs / 1000000000ull);
+  xTime.it_value.tv_nsec = (long)(ullNs % 1000000000ull);
+  if (ullNs == 0) {
+    xTime.it_value.tv_nsec = 1; // a zero value would disarm the timer
+  }
+  if (iGptmrContinuous[slice] != 0) {
+    ullNs = ((uint64_t)ulGptmrThreshold[slice] * ulGptmrDivider * 1000) / (configCPU_CLOCK_HZ / 1000000);
+    xTime.it_interval.tv_sec = (time_t)(ullNs / 1000000000ull);
+    xTime.it_interval.tv_nsec = (long)(ullNs % 1000000000ull);
+  }
+  timer_settime(xGptmrTimer[slice], 0, &xTime, NULL);
+}
+
+void neorv32_gptmr_disable_single(int slice) {
+
+  struct itimerspec xTime = { 0 };
+
+  timer_settime(xGptmrTimer[slice], 0, &xTime, NULL);
+}
+
+uint32_t neorv32_gptmr_irq_get(void) {
+
+  return __atomic_load_n(&ulGptmrPending, __ATOMIC_SEQ_CST);
+}
+
+void neorv32_gptmr_irq_ack(uint32_t mask) {
+
+  __atomic_fetch_and(&ulGptmrPending, ~mask, __ATOMIC_SEQ_CST);
+}
+
+void neorv32_host_gptmr_irq_attach(void (*handler)(void)) {
+
+  pxGptmrHandler = handler;
+}
+
+
+/******************************************************************************
+ * CPU.
+ ******************************************************************************/
+uint64_t neorv32_cpu_get_cycle(void) {
+
+  return neorv32_clint_time_get();
+}
+
+void neorv32_cpu_sleep(void) {
+
+  usleep(1000); // the tick "interrupt" wakes the idle task anyway
+}
@@ -0,0 +1,346 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * High-resolution timer service (GPTMR)
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Timer service and FIRQ dispatcher */
+#include "hrtimer.h"
+#include "irq.h"
+#include "irq_mask.h"
+
+/* Maximum number of GPTMR slices */
+#define hrtimerMAX_SLICES   ( 16 )
+
+/* Prototypes */
+static void prvInsert(HrTimer_t *pxTimer);
+static BaseType_t prvRemove(HrTimer_t *pxTimer);
+static void prvArm(void);
+static void prvHrTimerIrqHandler(void *pvContext);
+
+/* Active timers sorted by deadline */
+static HrTimer_t *pxActiveList = NULL;
+
+/* GPTMR available and set up? */
+static BaseType_t xServiceRunning = pdFALSE;
+
+/* Maximum dispatch latency (MTIME cycles from deadline to callback/notification) */
+static volatile uint32_t ulMaxLatency = 0;
+
+/* Handlers of the other GPTMR slices (xHrTimerAttachSlice()) */
+static HrTimerCallback_t pxSliceHandler[hrtimerMAX_SLICES];
+static void *pvSliceContext[hrtimerMAX_SLICES];
+static volatile uint32_t ulAttachedSlices = 0;
+
+
+/******************************************************************************
+ * Insert a timer into the active list (interrupts masked). Timers with the
+ * same deadline expire in the order they were started.
+ ******************************************************************************/
+configFAST_TEXT static void prvInsert(HrTimer_t *pxTimer) {
+
+  HrTimer_t **ppxLink = &pxActiveList;
+
+  while ((*ppxLink != NULL) && ((*ppxLink)->ullDeadline <= pxTimer->ullDeadline)) {
+    ppxLink = &(*ppxLink)->pxNext;
+  }
+  pxTimer->pxNext = *ppxLink;
+  *ppxLink = pxTimer;
+  pxTimer->xActive = pdTRUE;
+}
+
+
+/******************************************************************************
+ * Remove a timer from the active list (interrupts masked). Returns pdTRUE if
+ * the timer was the first one.
+ ******************************************************************************/
+configFAST_TEXT static BaseType_t prvRemove(HrTimer_t *pxTimer) {
+
+  HrTimer_t **ppxLink = &pxActiveList;
+
+  if (pxTimer->xActive == pdFALSE) {
+    return pdFALSE;
+  }
+  pxTimer->xActive = pdFALSE;
+
+  while (*ppxLink != pxTimer) {
+    ppxLink = &(*ppxLink)->pxNext;
+  }
+  *ppxLink = pxTimer->pxNext;
+  return (ppxLink == &pxActiveList) ? pdTRUE : pdFALSE;
+}
+
+
+/******************************************************************************
+ * Program the GPTMR slice to the earliest deadline (interrupts masked). The
+ * slice counts from zero, so a deadline that passes while it is programmed
+ * only causes an interrupt one GPTMR clock later. Deadlines beyond the range
+ * of the 32-bit threshold cause an early interrupt that just re-arms.
+ ******************************************************************************/
+configFAST_TEXT static void prvArm(void) {
+
+  uint64_t ullNow, ullDelta;
+  uint32_t ulThreshold = 1;
+
+  neorv32_gptmr_disable_single(configHRTIMER_GPTMR_SLICE);
+  if (pxActiveList == NULL) {
+    return;
+  }
+
+  ullNow = neorv32_clint_time_get();
+  if (pxActiveList->ullDeadline > ullNow) {
+    ullDelta = (pxActiveList->ullDeadline - ullNow + hrtimerCLOCK_DIV - 1) / hrtimerCLOCK_DIV;
+    ulThreshold = (ullDelta > 0xffffffffu) ? 0xffffffffu : (uint32_t)ullDelta;
+  }
+
+  neorv32_gptmr_configure(configHRTIMER_GPTMR_SLICE, 0, ulThreshold, 0); // single-shot
+  neorv32_gptmr_enable_single(configHRTIMER_GPTMR_SLICE);
+}
+
+
+/******************************************************************************
+ * GPTMR interrupt: call the handlers of attached slices, then dispatch all
+ * expired timers and re-arm. The active list is only touched with interrupts
+ * masked; callbacks run with the interrupt state of the handler (preemptible
+ * with interrupt nesting).
+ ******************************************************************************/
+configFAST_TEXT static void prvHrTimerIrqHandler(void *pvContext) {
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  uint32_t ulStatus, ulPending, ulSlice;
+  HrTimer_t *pxTimer;
+  uint64_t ullNow;
+  uint32_t ulLatency;
+
+  (void)pvContext;
+
+  ulPending = neorv32_gptmr_irq_get();
+  ulSlice = 0;
+  while ((ulPending & ulAttachedSlices) != 0) {
+    if (ulPending & ulAttachedSlices & (1u << ulSlice)) {
+      ulPending &= ~(1u << ulSlice);
+      neorv32_gptmr_irq_ack(1u << ulSlice);
+      pxSliceHandler[ulSlice](pvSliceContext[ulSlice]);
+    }
+    ulSlice++;
+  }
+  if ((ulPending & (1u << configHRTIMER_GPTMR_SLICE)) == 0) {
+    return;
+  }
+
+  ulStatus = ulIrqMaskSave();
+  neorv32_gptmr_disable_single(configHRTIMER_GPTMR_SLICE);
+  neorv32_gptmr_irq_ack(1u << configHRTIMER_GPTMR_SLICE);
+
+  for (;;) {
+    ullNow = neorv32_clint_time_get();
+    pxTimer = pxActiveList;
+    if ((pxTimer == NULL) || (pxTimer->ullDeadline > ullNow)) {
+      break;
+    }
+
+    ulLatency = (uint32_t)(ullNow - pxTimer->ullDeadline);
+    if (ulLatency > ulMaxLatency) {
+      ulMaxLatency = ulLatency;
+    }
+
+    // dequeue before calling back so the callback can restart or stop the timer
+    pxActiveList = pxTimer->pxNext;
+    pxTimer->xActive = pdFALSE;
+    pxTimer->ullExpired = pxTimer->ullDeadline;
+    if (pxTimer->ullPeriod != 0) {
+      pxTimer->ullDeadline += pxTimer->ullPeriod;
+      if (pxTimer->ullDeadline <= ullNow) { // overrun: skip the missed periods
+        pxTimer->ullDeadline = ullNow + pxTimer->ullPeriod;
+      }
+      prvInsert(pxTimer);
+    }
+
+    if (pxTimer->xTask != NULL) {
+      xTaskNotifyIndexedFromISR(pxTimer->xTask, configHRTIMER_NOTIFY_INDEX, pxTimer->ulBits, eSetBits,
+                                &xHigherPriorityTaskWoken);
+    }
+    else {
+      vIrqMaskRestore(ulStatus);
+      pxTimer->pxCallback(pxTimer->pvContext);
+      ulStatus = ulIrqMaskSave();
+    }
+  }
+
+  prvArm();
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  vIrqMaskRestore(ulStatus);
+}
+
+
+/******************************************************************************
+ * Set up the GPTMR and install its interrupt handler. The timer service owns
+ * the GPTMR clock prescaler and configHRTIMER_GPTMR_SLICE.
+ ******************************************************************************/
+void vHrTimerServiceInit(void) {
+
+  if (neorv32_gptmr_available() == 0) {
+    return;
+  }
+
+  neorv32_gptmr_setup(hrtimerPRESCALER);
+  neorv32_gptmr_disable_single(configHRTIMER_GPTMR_SLICE);
+  xNeorv32IrqAttach(neorv32IRQ_CHANNEL(GPTMR_TRAP_CODE), prvHrTimerIrqHandler, NULL);
+  xServiceRunning = pdTRUE;
+}
+
+
+/******************************************************************************
+ * Install the interrupt handler of another GPTMR slice. The caller programs
+ * and enables the slice; pxHandler is called in interrupt context (after the
+ * slice's interrupt has been acknowledged) with pvContext. Returns pdFAIL if
+ * there is no GPTMR or the slice is not available.
+ ******************************************************************************/
+BaseType_t xHrTimerAttachSlice(uint32_t ulSlice, HrTimerCallback_t pxHandler, void *pvContext) {
+
+  uint32_t ulStatus;
+
+  if ((xServiceRunning == pdFALSE) || (pxHandler == NULL) || (ulSlice == configHRTIMER_GPTMR_SLICE) ||
+      (ulSlice >= hrtimerMAX_SLICES) || (ulSlice >= (uint32_t)neorv32_gptmr_get_num_slices())) {
+    return pdFAIL;
+  }
+
+  ulStatus = ulIrqMaskSave();
+  pxSliceHandler[ulSlice] = pxHandler;
+  pvSliceContext[ulSlice] = pvContext;
+  ulAttachedSlices |= 1u << ulSlice;
+  vIrqMaskRestore(ulStatus);
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Initialize a timer that calls pxCallback in interrupt context.
+ ******************************************************************************/
+void vHrTimerInit(HrTimer_t *pxTimer, HrTimerCallback_t pxCallback, void *pvContext) {
+
+  configASSERT(pxCallback != NULL);
+
+  pxTimer->pxNext = NULL;
+  pxTimer->ullDeadline = 0;
+  pxTimer->ullPeriod = 0;
+  pxTimer->ullExpired = 0;
+  pxTimer->pxCallback = pxCallback;
+  pxTimer->pvContext = pvContext;
+  pxTimer->xTask = NULL;
+  pxTimer->ulBits = 0;
+  pxTimer->xActive = pdFALSE;
+}
+
+
+/******************************************************************************
+ * Initialize a timer that sets ulBits in xTask's notification value
+ * (configHRTIMER_NOTIFY_INDEX, see ulHrTimerWait()).
+ ******************************************************************************/
+void vHrTimerInitDeferred(HrTimer_t *pxTimer, TaskHandle_t xTask, uint32_t ulBits) {
+
+  configASSERT((xTask != NULL) && (ulBits != 0));
+
+  pxTimer->pxNext = NULL;
+  pxTimer->ullDeadline = 0;
+  pxTimer->ullPeriod = 0;
+  pxTimer->ullExpired = 0;
+  pxTimer->pxCallback = NULL;
+  pxTimer->pvContext = NULL;
+  pxTimer->xTask = xTask;
+  pxTimer->ulBits = ulBits;
+  pxTimer->xActive = pdFALSE;
+}
+
+
+/******************************************************************************
+ * (Re-)start a timer: first expiry after ulDelayUs microseconds, then every
+ * ulPeriodUs microseconds (0 = one-shot). Returns pdFAIL if there is no
+ * GPTMR.
+ ******************************************************************************/
+configFAST_TEXT BaseType_t xHrTimerStart(HrTimer_t *pxTimer, uint32_t ulDelayUs, uint32_t ulPeriodUs) {
+
+  uint32_t ulStatus;
+  BaseType_t xWasFirst;
+
+  if (xServiceRunning == pdFALSE) {
+    return pdFAIL;
+  }
+
+  ulStatus = ulIrqMaskSave();
+  xWasFirst = prvRemove(pxTimer);
+  pxTimer->ullDeadline = neorv32_clint_time_get() + hrtimerUS_TO_CYCLES(ulDelayUs);
+  pxTimer->ullPeriod = hrtimerUS_TO_CYCLES(ulPeriodUs);
+  prvInsert(pxTimer);
+  if ((xWasFirst != pdFALSE) || (pxActiveList == pxTimer)) { // earliest deadline changed
+    prvArm();
+  }
+  vIrqMaskRestore(ulStatus);
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Stop a timer (no effect if it is not active).
+ ******************************************************************************/
+void vHrTimerStop(HrTimer_t *pxTimer) {
+
+  uint32_t ulStatus = ulIrqMaskSave();
+
+  if (prvRemove(pxTimer) != pdFALSE) {
+    prvArm();
+  }
+  vIrqMaskRestore(ulStatus);
+}
+
+
+/******************************************************************************
+ * Check if a timer is active.
+ ******************************************************************************/
+BaseType_t xHrTimerIsActive(const HrTimer_t *pxTimer) {
+
+  return pxTimer->xActive;
+}
+
+
+/******************************************************************************
+ * Block the calling task until one of its deferred timers expired. Returns
+ * the notification bits of the expired timers (0 on timeout).
+ ******************************************************************************/
+uint32_t ulHrTimerWait(TickType_t xTicksToWait) {
+
+  uint32_t ulBits = 0;
+
+  xTaskNotifyWaitIndexed(configHRTIMER_NOTIFY_INDEX, 0, 0xffffffffu, &ulBits, xTicksToWait);
+  return ulBits;
+}
+
+
+/******************************************************************************
+ * Get the current time (MTIME cycles, the time base of all deadlines).
+ ******************************************************************************/
+uint64_t ullHrTimerGetTime(void) {
+
+  return neorv32_clint_time_get();
+}
+
+
+/******************************************************************************
+ * Get the maximum dispatch latency (MTIME cycles from the deadline to the
+ * callback or notification).
+ ******************************************************************************/
+uint32_t ulHrTimerGetMaxLatency(void) {
+
+  return ulMaxLatency;
+}
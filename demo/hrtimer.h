@@ -0,0 +1,76 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * High-resolution timer service (GPTMR)
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Any number of one-shot or periodic timers with microsecond resolution,
+ * independent of the kernel tick (configTICK_RATE_HZ) and of the timer
+ * service task. All active timers are kept in a list sorted by deadline;
+ * one GPTMR slice (configHRTIMER_GPTMR_SLICE) is always programmed to the
+ * earliest deadline. Deadlines are absolute CLINT MTIME values, so periodic
+ * timers do not drift.
+ *
+ * Expired timers either call their callback in interrupt context
+ * (vHrTimerInit()) or set notification bits of a task (vHrTimerInitDeferred(),
+ * notification index configHRTIMER_NOTIFY_INDEX). Such a task waits using
+ * ulHrTimerWait().
+ *
+ * xHrTimerStart() and vHrTimerStop() can be called from tasks, interrupt
+ * handlers and timer callbacks. Timers have to stay valid while they are
+ * active.
+ *
+ * All GPTMR slices share one interrupt. Other users of the GPTMR (e.g. the
+ * PC-sampling profiler) program their own slice and install its handler with
+ * xHrTimerAttachSlice(); the service acknowledges the slice and calls it.
+ ******************************************************************************/
+
+#ifndef HRTIMER_H
+#define HRTIMER_H
+
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Detected clock */
+#include "platform.h"
+
+/* GPTMR clock: CPU clock / 2; the prescaler is shared by all slices and set by vHrTimerServiceInit() */
+#define hrtimerPRESCALER                ( CLK_PRSC_2 )
+#define hrtimerCLOCK_DIV                ( 2u )
+
+/* Convert microseconds to MTIME cycles */
+#define hrtimerUS_TO_CYCLES( ulUs ) ullPlatformMulU32( ( uint32_t )( ulUs ), ulPlatformCyclesPerUs )
+
+/* Timer callback; called in interrupt context with the context pointer given at initialization */
+typedef void (*HrTimerCallback_t)(void *pvContext);
+
+/* Timer */
+typedef struct HrTimer {
+  struct HrTimer *pxNext;        // next active timer (sorted by deadline)
+  uint64_t ullDeadline;          // MTIME of the next expiry
+  uint64_t ullPeriod;            // MTIME cycles; 0 = one-shot
+  uint64_t ullExpired;           // deadline of the latest expiry (valid in the callback / after the notification)
+  HrTimerCallback_t pxCallback;  // interrupt context callback ...
+  void *pvContext;
+  TaskHandle_t xTask;            // ... or task to be notified
+  uint32_t ulBits;
+  volatile BaseType_t xActive;
+} HrTimer_t;
+
+void vHrTimerServiceInit(void);
+void vHrTimerInit(HrTimer_t *pxTimer, HrTimerCallback_t pxCallback, void *pvContext);
+void vHrTimerInitDeferred(HrTimer_t *pxTimer, TaskHandle_t xTask, uint32_t ulBits);
+BaseType_t xHrTimerStart(HrTimer_t *pxTimer, uint32_t ulDelayUs, uint32_t ulPeriodUs);
+void vHrTimerStop(HrTimer_t *pxTimer);
+BaseType_t xHrTimerIsActive(const HrTimer_t *pxTimer);
+uint32_t ulHrTimerWait(TickType_t xTicksToWait);
+uint64_t ullHrTimerGetTime(void);
+uint32_t ulHrTimerGetMaxLatency(void);
+BaseType_t xHrTimerAttachSlice(uint32_t ulSlice, HrTimerCallback_t pxHandler, void *pvContext);
+
+#endif /* HRTIMER_H */
@@ -0,0 +1,295 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Table-driven fast interrupt (FIRQ) dispatcher
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* FIRQ dispatcher and logging */
+#include "irq.h"
+#include "irq_mask.h"
+#include "binlog.h"
+
+/* Prototypes */
+static void prvUnhandledIrq(void *pvContext);
+static void prvDeferToTask(void *pvContext);
+static inline uint32_t prvMieBit(uint32_t ulChannel);
+#if ( configUSE_IRQ_NESTING == 1 )
+static inline void prvUpdateMie(void);
+#endif
+
+/* Dispatch table; every entry is always valid so dispatching needs no checks */
+IrqEntry_t xNeorv32IrqTable[neorv32IRQ_NUM_CHANNELS] = {
+  [0 ... (neorv32IRQ_NUM_CHANNELS - 1)] = { prvUnhandledIrq, NULL, 0, 0 }
+};
+
+/* Current nesting depth of the dispatcher (0 = not in a dispatched handler) */
+volatile uint32_t ulNeorv32IrqNesting = 0;
+
+#if ( configUSE_IRQ_NESTING == 1 )
+/* PC interrupted by the currently dispatched handler (mepc as saved on entry) */
+volatile uint32_t ulNeorv32IrqMepc = 0;
+
+/* mie bits of all channels */
+#define irqMIE_CHANNELS ( 0xffff0000u | ( 1u << CSR_MIE_MSIE ) )
+
+/* Channels enabled by software and channels allowed to preempt the current level (mie bits); the
+ * channel bits of mie are always ulEnabled & ulAllowed */
+static uint32_t ulEnabled = 0;
+static uint32_t ulAllowed = irqMIE_CHANNELS;
+
+/* Channels of a higher priority than the index (mie bits) */
+static uint32_t ulPreempting[configIRQ_PRIORITIES] = { 0 };
+
+/* Trap entries (kernel and nested, irq_nest.S) */
+extern void freertos_risc_v_trap_handler(void);
+extern void freertos_risc_v_nested_trap_handler(void);
+#endif
+
+
+/******************************************************************************
+ * mie bit of a channel.
+ ******************************************************************************/
+static inline uint32_t prvMieBit(uint32_t ulChannel) {
+
+  return (ulChannel < neorv32IRQ_NUM_FIRQ) ? (1u << (CSR_MIE_FIRQ0E + ulChannel)) : (1u << CSR_MIE_MSIE);
+}
+
+
+#if ( configUSE_IRQ_NESTING == 1 )
+/******************************************************************************
+ * Write the channel bits of mie (interrupts have to be disabled).
+ ******************************************************************************/
+static inline void prvUpdateMie(void) {
+
+  uint32_t ulMie = neorv32_cpu_csr_read(CSR_MIE);
+
+  neorv32_cpu_csr_write(CSR_MIE, (ulMie & ~irqMIE_CHANNELS) | (ulEnabled & ulAllowed));
+}
+
+
+/******************************************************************************
+ * Dispatch a channel (interrupts are disabled). If there are channels of a
+ * higher priority, the handler runs with interrupts enabled and only those
+ * channels (and the MTIME tick) unmasked; traps are taken by the nested
+ * entry (irq_nest.S) meanwhile.
+ ******************************************************************************/
+configFAST_TEXT void vNeorv32IrqDispatchNested(uint32_t ulChannel) {
+
+  IrqEntry_t *pxEntry = &xNeorv32IrqTable[ulChannel];
+  uint32_t ulPrevAllowed = ulAllowed;
+  uint32_t ulPrevMepc = ulNeorv32IrqMepc;
+  uint32_t ulMepc, ulMstatus;
+
+  pxEntry->ulCount++;
+  ulAllowed = ulPrevAllowed & ulPreempting[pxEntry->ulPriority];
+
+  // state of this level, overwritten by nested traps
+  ulMepc = neorv32_cpu_csr_read(CSR_MEPC);
+  ulNeorv32IrqMepc = ulMepc;
+
+  if (ulAllowed == 0) { // cannot be preempted
+    ulNeorv32IrqNesting++;
+    pxEntry->pxHandler(pxEntry->pvContext);
+    ulNeorv32IrqNesting--;
+    ulAllowed = ulPrevAllowed;
+    ulNeorv32IrqMepc = ulPrevMepc;
+    return;
+  }
+
+  ulMstatus = neorv32_cpu_csr_read(CSR_MSTATUS);
+  if (ulNeorv32IrqNesting++ == 0) {
+    neorv32_cpu_csr_write(CSR_MTVEC, (uint32_t)&freertos_risc_v_nested_trap_handler);
+  }
+  prvUpdateMie();
+
+  __asm volatile ("csrs mstatus, 8" : : : "memory");
+  pxEntry->pxHandler(pxEntry->pvContext);
+  __asm volatile ("csrc mstatus, 8" : : : "memory");
+
+  ulAllowed = ulPrevAllowed;
+  prvUpdateMie();
+  if (--ulNeorv32IrqNesting == 0) {
+    neorv32_cpu_csr_write(CSR_MTVEC, (uint32_t)&freertos_risc_v_trap_handler);
+  }
+  neorv32_cpu_csr_write(CSR_MSTATUS, ulMstatus);
+  neorv32_cpu_csr_write(CSR_MEPC, ulMepc);
+  ulNeorv32IrqMepc = ulPrevMepc;
+}
+
+
+/******************************************************************************
+ * Set the nesting priority of a channel (0..configIRQ_PRIORITIES-1; default
+ * 0). Handlers are preempted by channels of a higher priority only.
+ ******************************************************************************/
+void vNeorv32IrqSetPriority(uint32_t ulChannel, uint32_t ulPriority) {
+
+  uint32_t ulStatus, ulLevel, i;
+
+  if ((ulChannel >= neorv32IRQ_NUM_CHANNELS) || (ulPriority >= configIRQ_PRIORITIES)) {
+    return;
+  }
+
+  ulStatus = ulIrqMaskSave();
+  xNeorv32IrqTable[ulChannel].ulPriority = ulPriority;
+  for (ulLevel = 0; ulLevel < configIRQ_PRIORITIES; ulLevel++) {
+    ulPreempting[ulLevel] = 0;
+    for (i = 0; i < neorv32IRQ_NUM_CHANNELS; i++) {
+      if (xNeorv32IrqTable[i].ulPriority > ulLevel) {
+        ulPreempting[ulLevel] |= prvMieBit(i);
+      }
+    }
+  }
+  vIrqMaskRestore(ulStatus);
+}
+
+#else
+
+/******************************************************************************
+ * Interrupt nesting disabled: priorities are ignored.
+ ******************************************************************************/
+void vNeorv32IrqSetPriority(uint32_t ulChannel, uint32_t ulPriority) {
+
+  if (ulChannel < neorv32IRQ_NUM_CHANNELS) {
+    xNeorv32IrqTable[ulChannel].ulPriority = ulPriority;
+  }
+}
+#endif
+
+
+/******************************************************************************
+ * Default handler: report and disable the channel (the FIRQs are
+ * level-triggered and would fire again immediately).
+ ******************************************************************************/
+static void prvUnhandledIrq(void *pvContext) {
+
+  uint32_t ulChannel = ulNeorv32IrqGetChannel(neorv32_cpu_csr_read(CSR_MCAUSE));
+
+  (void)pvContext;
+
+  vNeorv32IrqDisable(ulChannel);
+  BINLOG_ISR("<NEORV32-IRQ> Unhandled FIRQ %u </NEORV32-IRQ>", ulChannel);
+}
+
+
+/******************************************************************************
+ * Deferred handler: disable the channel and notify the handler task.
+ ******************************************************************************/
+configFAST_TEXT static void prvDeferToTask(void *pvContext) {
+
+  uint32_t ulChannel = ulNeorv32IrqGetChannel(neorv32_cpu_csr_read(CSR_MCAUSE));
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+  vNeorv32IrqDisable(ulChannel);
+  xTaskNotifyIndexedFromISR((TaskHandle_t)pvContext, configIRQ_NOTIFY_INDEX, 1u << ulChannel, eSetBits,
+                            &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+
+/******************************************************************************
+ * Install an interrupt handler for a FIRQ channel and enable the channel.
+ ******************************************************************************/
+BaseType_t xNeorv32IrqAttach(uint32_t ulChannel, IrqHandler_t pxHandler, void *pvContext) {
+
+  if ((ulChannel >= neorv32IRQ_NUM_CHANNELS) || (pxHandler == NULL)) {
+    return pdFAIL;
+  }
+
+  vNeorv32IrqDisable(ulChannel);
+  xNeorv32IrqTable[ulChannel].pvContext = pvContext;
+  xNeorv32IrqTable[ulChannel].pxHandler = pxHandler;
+  vNeorv32IrqEnable(ulChannel);
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Defer all handling of a FIRQ channel to a task and enable the channel.
+ ******************************************************************************/
+BaseType_t xNeorv32IrqAttachDeferred(uint32_t ulChannel, TaskHandle_t xHandlerTask) {
+
+  if (xHandlerTask == NULL) {
+    return pdFAIL;
+  }
+  return xNeorv32IrqAttach(ulChannel, prvDeferToTask, (void *)xHandlerTask);
+}
+
+
+/******************************************************************************
+ * Disable a FIRQ channel and restore the default handler.
+ ******************************************************************************/
+void vNeorv32IrqDetach(uint32_t ulChannel) {
+
+  if (ulChannel < neorv32IRQ_NUM_CHANNELS) {
+    vNeorv32IrqDisable(ulChannel);
+    xNeorv32IrqTable[ulChannel].pxHandler = prvUnhandledIrq;
+    xNeorv32IrqTable[ulChannel].pvContext = NULL;
+  }
+}
+
+
+/******************************************************************************
+ * Enable a channel.
+ ******************************************************************************/
+void vNeorv32IrqEnable(uint32_t ulChannel) {
+
+#if ( configUSE_IRQ_NESTING == 1 )
+  uint32_t ulStatus = ulIrqMaskSave();
+  ulEnabled |= prvMieBit(ulChannel);
+  prvUpdateMie();
+  vIrqMaskRestore(ulStatus);
+#else
+  neorv32_cpu_csr_set(CSR_MIE, prvMieBit(ulChannel));
+#endif
+}
+
+
+/******************************************************************************
+ * Disable a channel.
+ ******************************************************************************/
+configFAST_TEXT void vNeorv32IrqDisable(uint32_t ulChannel) {
+
+#if ( configUSE_IRQ_NESTING == 1 )
+  uint32_t ulStatus = ulIrqMaskSave();
+  ulEnabled &= ~prvMieBit(ulChannel);
+  prvUpdateMie();
+  vIrqMaskRestore(ulStatus);
+#else
+  neorv32_cpu_csr_clr(CSR_MIE, prvMieBit(ulChannel));
+#endif
+}
+
+
+/******************************************************************************
+ * Block the calling (handler) task until one of its deferred FIRQs fired.
+ * Returns a bit mask of the channels that fired (0 on timeout).
+ ******************************************************************************/
+uint32_t ulNeorv32IrqWait(TickType_t xTicksToWait) {
+
+  uint32_t ulChannels = 0;
+
+  xTaskNotifyWaitIndexed(configIRQ_NOTIFY_INDEX, 0, 0xffffffffu, &ulChannels, xTicksToWait);
+  return ulChannels;
+}
+
+
+/******************************************************************************
+ * Get the number of times a FIRQ channel has been dispatched.
+ ******************************************************************************/
+uint32_t ulNeorv32IrqGetCount(uint32_t ulChannel) {
+
+  if (ulChannel >= neorv32IRQ_NUM_CHANNELS) {
+    return 0;
+  }
+  return xNeorv32IrqTable[ulChannel].ulCount;
+}
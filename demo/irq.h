@@ -0,0 +1,117 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Table-driven fast interrupt (FIRQ) dispatcher
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Handlers for the 16 NEORV32 fast interrupt channels are registered at run
+ * time. Dispatching is a constant-time indexed call, so adding interrupt
+ * sources does not increase the latency of the existing ones.
+ *
+ * xNeorv32IrqAttach() installs a handler that runs in interrupt context.
+ *
+ * xNeorv32IrqAttachDeferred() defers all work to a handler task: the FIRQ
+ * channel is disabled (the NEORV32 FIRQs are level-triggered) and the task is
+ * woken via a direct-to-task notification that has the channel's bit set.
+ * The task waits using ulNeorv32IrqWait(), services the peripheral and then
+ * re-enables the channel using vNeorv32IrqEnable().
+ *
+ * Channels are identified by their number (0..15); neorv32IRQ_CHANNEL()
+ * converts the HAL's *_TRAP_CODE definitions. The CLINT machine software
+ * interrupt is handled as an additional channel (neorv32IRQ_CHANNEL_MSI).
+ *
+ * Interrupt nesting (configUSE_IRQ_NESTING, "make IRQ_NESTING=1"): every
+ * channel has a priority (vNeorv32IrqSetPriority(), 0..configIRQ_PRIORITIES-1,
+ * default 0). A handler runs with interrupts enabled if there are channels of
+ * a higher priority; only those (and the MTIME tick, which is short and never
+ * preempted itself) can preempt it. The kernel's FromISR API and
+ * portYIELD_FROM_ISR() mask interrupts while they work on kernel data
+ * (portmacro.h), so they can be used at every priority. Handler code that
+ * shares data with a handler of another priority has to mask interrupts
+ * around it (irq_mask.h, as console.c, dma.c, bufpool.c and hrtimer.c do). Nested
+ * handlers run on the ISR stack (configISR_STACK_SIZE_WORDS); single-core
+ * port only. A nested trap overwrites mepc, so a handler that needs the
+ * interrupted PC reads ulNeorv32IrqMepc instead.
+ ******************************************************************************/
+
+#ifndef IRQ_H
+#define IRQ_H
+
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+#define neorv32IRQ_NUM_FIRQ              ( 16 )
+#define neorv32IRQ_CHANNEL_MSI           ( 16 ) // machine software interrupt (CLINT MSIP)
+#define neorv32IRQ_NUM_CHANNELS          ( 17 )
+#define neorv32IRQ_CHANNEL( ulTrapCode ) ( ( uint32_t )( ulTrapCode ) & 0xfu )
+
+/* Interrupt handler; called with the context pointer given at registration */
+typedef void (*IrqHandler_t)(void *pvContext);
+
+/* Dispatch table entry */
+typedef struct {
+  IrqHandler_t pxHandler;
+  void *pvContext;
+  volatile uint32_t ulCount; // number of times this channel has been dispatched
+  uint32_t ulPriority;       // nesting priority (configUSE_IRQ_NESTING)
+} IrqEntry_t;
+
+extern IrqEntry_t xNeorv32IrqTable[neorv32IRQ_NUM_CHANNELS];
+extern volatile uint32_t ulNeorv32IrqNesting;
+#if ( configUSE_IRQ_NESTING == 1 )
+extern volatile uint32_t ulNeorv32IrqMepc;
+#endif
+
+BaseType_t xNeorv32IrqAttach(uint32_t ulChannel, IrqHandler_t pxHandler, void *pvContext);
+BaseType_t xNeorv32IrqAttachDeferred(uint32_t ulChannel, TaskHandle_t xHandlerTask);
+void vNeorv32IrqDetach(uint32_t ulChannel);
+void vNeorv32IrqEnable(uint32_t ulChannel);
+void vNeorv32IrqDisable(uint32_t ulChannel);
+uint32_t ulNeorv32IrqWait(TickType_t xTicksToWait);
+uint32_t ulNeorv32IrqGetCount(uint32_t ulChannel);
+void vNeorv32IrqSetPriority(uint32_t ulChannel, uint32_t ulPriority);
+void vNeorv32IrqDispatchNested(uint32_t ulChannel);
+
+
+/******************************************************************************
+ * Get the channel of an interrupt cause (neorv32IRQ_NUM_CHANNELS if the cause
+ * is neither a FIRQ nor the software interrupt).
+ ******************************************************************************/
+static inline uint32_t ulNeorv32IrqGetChannel(uint32_t ulCause) {
+
+  uint32_t ulChannel = ulCause - TRAP_CODE_FIRQ_0;
+
+  if (ulChannel < neorv32IRQ_NUM_FIRQ) {
+    return ulChannel;
+  }
+  return (ulCause == TRAP_CODE_MSI) ? neorv32IRQ_CHANNEL_MSI : neorv32IRQ_NUM_CHANNELS;
+}
+
+
+/******************************************************************************
+ * Dispatch a FIRQ or the software interrupt. Returns pdFALSE for any other
+ * cause.
+ ******************************************************************************/
+static inline BaseType_t xNeorv32IrqDispatch(uint32_t ulCause) {
+
+  uint32_t ulChannel = ulNeorv32IrqGetChannel(ulCause);
+
+  if (ulChannel >= neorv32IRQ_NUM_CHANNELS) {
+    return pdFALSE;
+  }
+
+#if ( configUSE_IRQ_NESTING == 1 )
+  vNeorv32IrqDispatchNested(ulChannel);
+#else
+  xNeorv32IrqTable[ulChannel].ulCount++;
+  xNeorv32IrqTable[ulChannel].pxHandler(xNeorv32IrqTable[ulChannel].pvContext);
+#endif
+  return pdTRUE;
+}
+
+#endif /* IRQ_H */
@@ -0,0 +1,51 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Global interrupt masking
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Short sections that are shared between tasks and interrupt handlers (or
+ * between handlers of different priorities, configUSE_IRQ_NESTING) clear
+ * mstatus.MIE and restore it afterwards:
+ *
+ *   uint32_t ulStatus = ulIrqMaskSave();
+ *   ...
+ *   vIrqMaskRestore(ulStatus);
+ *
+ * Both are a single CSR access and can be nested and used from any context.
+ * Only the interrupts of the calling hart are masked.
+ *
+ * This file is included by FreeRTOSConfig.h (via trace.h) and portmacro.h, so
+ * it must not depend on any FreeRTOS types.
+ ******************************************************************************/
+
+#ifndef IRQ_MASK_H
+#define IRQ_MASK_H
+
+#if !defined(__ASSEMBLER__)
+
+#include <stdint.h>
+
+
+/******************************************************************************
+ * Disable interrupts globally; returns the previous mstatus.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t ulIrqMaskSave(void) {
+
+  uint32_t ulStatus;
+
+  __asm volatile ("csrrci %0, mstatus, 8" : "=r" (ulStatus) : : "memory");
+  return ulStatus;
+}
+
+
+/******************************************************************************
+ * Restore the global interrupt enable from an ulIrqMaskSave() result.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vIrqMaskRestore(uint32_t ulStatus) {
+
+  __asm volatile ("csrs mstatus, %0" : : "r" (ulStatus & 8u) : "memory");
+}
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* IRQ_MASK_H */
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Lock-free primitives
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Lock-free primitives */
+#include "lockfree.h"
+
+
+/******************************************************************************
+ * Initialize an SPSC ring using ulSlots words (power of two).
+ ******************************************************************************/
+void vSpscRingInit(SpscRing_t *pxRing, uint32_t *pulSlots, uint32_t ulSlots) {
+
+  configASSERT((ulSlots != 0) && ((ulSlots & (ulSlots - 1)) == 0));
+
+  pxRing->pulSlots = pulSlots;
+  pxRing->ulMask = ulSlots - 1;
+  pxRing->ulHead = 0;
+  pxRing->ulTail = 0;
+}
+
+
+/******************************************************************************
+ * Initialize an MPSC ring using ulSlots pointers (power of two).
+ ******************************************************************************/
+void vMpscRingInit(MpscRing_t *pxRing, void **ppvSlots, uint32_t ulSlots) {
+
+  uint32_t i;
+
+  configASSERT((ulSlots != 0) && ((ulSlots & (ulSlots - 1)) == 0));
+
+  for (i = 0; i < ulSlots; i++) {
+    ppvSlots[i] = NULL;
+  }
+  pxRing->ppvSlots = (void *volatile *)ppvSlots;
+  pxRing->ulMask = ulSlots - 1;
+  pxRing->ulHead = 0;
+  pxRing->ulTail = 0;
+}
+
+
+/******************************************************************************
+ * Put a (non-NULL) pointer into an MPSC ring (tasks and interrupt handlers).
+ * Returns pdFAIL if the ring is full. A producer that is preempted between
+ * reserving and publishing its slot only delays the consumer; it never
+ * blocks other producers.
+ ******************************************************************************/
+configFAST_TEXT BaseType_t xMpscRingPush(MpscRing_t *pxRing, void *pvItem) {
+
+  uint32_t ulHead;
+
+  configASSERT(pvItem != NULL);
+
+  do {
+    ulHead = pxRing->ulHead;
+    if ((ulHead - pxRing->ulTail) > pxRing->ulMask) {
+      return pdFAIL;
+    }
+  } while (xAtomicCompareAndSwap(&pxRing->ulHead, ulHead, ulHead + 1) == pdFALSE);
+
+  lockfreeFENCE(); // item content before the pointer
+  pxRing->ppvSlots[ulHead & pxRing->ulMask] = pvItem;
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Get the next pointer from an MPSC ring (single consumer). Returns NULL if
+ * the ring is empty or the next slot has been reserved but not published yet.
+ ******************************************************************************/
+configFAST_TEXT void *pvMpscRingPop(MpscRing_t *pxRing) {
+
+  uint32_t ulTail = pxRing->ulTail;
+  void *pvItem = pxRing->ppvSlots[ulTail & pxRing->ulMask];
+
+  if (pvItem != NULL) {
+    pxRing->ppvSlots[ulTail & pxRing->ulMask] = NULL;
+    lockfreeFENCE(); // slot cleared before it is released to the producers
+    pxRing->ulTail = ulTail + 1;
+  }
+  return pvItem;
+}
+
+
+/******************************************************************************
+ * Initialize an event-bit word.
+ ******************************************************************************/
+void vEventWordInit(EventWord_t *pxWord) {
+
+  pxWord->ulBits = 0;
+  pxWord->xWaiter = NULL;
+}
+
+
+/******************************************************************************
+ * Set event bits (task context) and wake up the waiting task.
+ ******************************************************************************/
+void vEventWordSet(EventWord_t *pxWord, uint32_t ulBits) {
+
+  TaskHandle_t xWaiter;
+
+  ulAtomicFetchOr(&pxWord->ulBits, ulBits);
+  xWaiter = pxWord->xWaiter;
+  if (xWaiter != NULL) {
+    xTaskNotifyGiveIndexed(xWaiter, configEVENT_WORD_NOTIFY_INDEX);
+  }
+}
+
+
+/******************************************************************************
+ * Set event bits (interrupt context) and wake up the waiting task.
+ ******************************************************************************/
+configFAST_TEXT void vEventWordSetFromISR(EventWord_t *pxWord, uint32_t ulBits, BaseType_t *pxHigherPriorityTaskWoken) {
+
+  TaskHandle_t xWaiter;
+
+  ulAtomicFetchOr(&pxWord->ulBits, ulBits);
+  xWaiter = pxWord->xWaiter;
+  if (xWaiter != NULL) {
+    vTaskNotifyGiveIndexedFromISR(xWaiter, configEVENT_WORD_NOTIFY_INDEX, pxHigherPriorityTaskWoken);
+  }
+}
+
+
+/******************************************************************************
+ * Take (get and clear) the pending event bits of ulMask. Blocks for up to
+ * xTicksToWait if none is pending; returns 0 on timeout. Only one task may
+ * wait on a word at a time.
+ ******************************************************************************/
+uint32_t ulEventWordWait(EventWord_t *pxWord, uint32_t ulMask, TickType_t xTicksToWait) {
+
+  uint32_t ulBits;
+  TimeOut_t xTimeOut;
+
+  vTaskSetTimeOutState(&xTimeOut);
+
+  // register before checking: a setter that misses the registration has set the bits before the check
+  pxWord->xWaiter = xTaskGetCurrentTaskHandle();
+  lockfreeFENCE();
+
+  for (;;) {
+    ulBits = ulAtomicFetchAnd(&pxWord->ulBits, ~ulMask) & ulMask;
+    if ((ulBits != 0) || (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)) {
+      break;
+    }
+    ulTaskNotifyTakeIndexed(configEVENT_WORD_NOTIFY_INDEX, pdTRUE, xTicksToWait);
+  }
+
+  pxWord->xWaiter = NULL;
+  return ulBits;
+}
@@ -0,0 +1,228 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Lock-free primitives
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * ISR-safe building blocks that do not disable interrupts if the image is
+ * built with the A extension (Zaamo/Zalrsc, e.g. MARCH=rv32ia_zicsr_zifencei):
+ *
+ * - atomic counters and flags: ulAtomicFetchAdd/Or/And(), ulAtomicSwap(),
+ *   xAtomicCompareAndSwap() (amoadd/amoor/amoand/amoswap, lr/sc)
+ * - SPSC ring of words (one producer, one consumer; no atomic instructions
+ *   needed at all)
+ * - MPSC ring of pointers (any number of producers in tasks and interrupt
+ *   handlers, one consumer): producers reserve a slot with a compare-and-swap
+ *   on the head index, a slot is published by writing the (non-NULL) pointer
+ * - event-bit word: set from tasks and interrupt handlers with a single
+ *   amoor, taken by one task that can block on it
+ *   (configEVENT_WORD_NOTIFY_INDEX)
+ *
+ * Without the A extension (rv32i) the read-modify-write operations fall back
+ * to masking interrupts for a few instructions, which is only safe on a
+ * single hart (all of the demo's drivers and interrupt handlers run on hart
+ * 0, see smp/port.c). The rings and the event word are built on these
+ * operations and work either way.
+ ******************************************************************************/
+
+#ifndef LOCKFREE_H
+#define LOCKFREE_H
+
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include "irq_mask.h"
+
+/* Atomic read-modify-write instructions available? */
+#if defined(__riscv_atomic) || (defined(__riscv_zaamo) && defined(__riscv_zalrsc))
+  #define lockfreeHAS_ATOMICS   ( 1 )
+#else
+  #define lockfreeHAS_ATOMICS   ( 0 )
+#endif
+
+/* Memory ordering between harts (a compiler barrier is sufficient on a single hart) */
+#if ( configNUMBER_OF_CORES > 1 )
+  #define lockfreeFENCE()       __asm volatile ("fence rw, rw" : : : "memory")
+#else
+  #define lockfreeFENCE()       __asm volatile ("" : : : "memory")
+#endif
+
+/* SPSC ring of 32-bit words */
+typedef struct {
+  uint32_t *pulSlots;            // power of two slots
+  uint32_t ulMask;               // number of slots - 1
+  volatile uint32_t ulHead;      // written by the producer only (free-running)
+  volatile uint32_t ulTail;      // written by the consumer only (free-running)
+} SpscRing_t;
+
+/* MPSC ring of pointers (NULL marks a free / not yet published slot) */
+typedef struct {
+  void *volatile *ppvSlots;      // power of two slots
+  uint32_t ulMask;               // number of slots - 1
+  volatile uint32_t ulHead;      // next slot to be reserved by a producer (free-running)
+  volatile uint32_t ulTail;      // written by the consumer only (free-running)
+} MpscRing_t;
+
+/* Event-bit word */
+typedef struct {
+  volatile uint32_t ulBits;      // pending events
+  TaskHandle_t volatile xWaiter; // task blocked in ulEventWordWait()
+} EventWord_t;
+
+void vSpscRingInit(SpscRing_t *pxRing, uint32_t *pulSlots, uint32_t ulSlots);
+void vMpscRingInit(MpscRing_t *pxRing, void **ppvSlots, uint32_t ulSlots);
+BaseType_t xMpscRingPush(MpscRing_t *pxRing, void *pvItem);
+void *pvMpscRingPop(MpscRing_t *pxRing);
+void vEventWordInit(EventWord_t *pxWord);
+void vEventWordSet(EventWord_t *pxWord, uint32_t ulBits);
+void vEventWordSetFromISR(EventWord_t *pxWord, uint32_t ulBits, BaseType_t *pxHigherPriorityTaskWoken);
+uint32_t ulEventWordWait(EventWord_t *pxWord, uint32_t ulMask, TickType_t xTicksToWait);
+
+
+/******************************************************************************
+ * Atomically add ulValue; returns the previous value.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t ulAtomicFetchAdd(volatile uint32_t *pulTarget, uint32_t ulValue) {
+
+#if ( lockfreeHAS_ATOMICS == 1 )
+  return __atomic_fetch_add(pulTarget, ulValue, __ATOMIC_SEQ_CST);
+#else
+  uint32_t ulStatus = ulIrqMaskSave();
+  uint32_t ulOld = *pulTarget;
+
+  *pulTarget = ulOld + ulValue;
+  vIrqMaskRestore(ulStatus);
+  return ulOld;
+#endif
+}
+
+
+/******************************************************************************
+ * Atomically set bits; returns the previous value.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t ulAtomicFetchOr(volatile uint32_t *pulTarget, uint32_t ulBits) {
+
+#if ( lockfreeHAS_ATOMICS == 1 )
+  return __atomic_fetch_or(pulTarget, ulBits, __ATOMIC_SEQ_CST);
+#else
+  uint32_t ulStatus = ulIrqMaskSave();
+  uint32_t ulOld = *pulTarget;
+
+  *pulTarget = ulOld | ulBits;
+  vIrqMaskRestore(ulStatus);
+  return ulOld;
+#endif
+}
+
+
+/******************************************************************************
+ * Atomically clear all bits not in ulMask; returns the previous value.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t ulAtomicFetchAnd(volatile uint32_t *pulTarget, uint32_t ulMask) {
+
+#if ( lockfreeHAS_ATOMICS == 1 )
+  return __atomic_fetch_and(pulTarget, ulMask, __ATOMIC_SEQ_CST);
+#else
+  uint32_t ulStatus = ulIrqMaskSave();
+  uint32_t ulOld = *pulTarget;
+
+  *pulTarget = ulOld & ulMask;
+  vIrqMaskRestore(ulStatus);
+  return ulOld;
+#endif
+}
+
+
+/******************************************************************************
+ * Atomically replace the value (e.g. test-and-set of a flag); returns the
+ * previous value.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t ulAtomicSwap(volatile uint32_t *pulTarget, uint32_t ulValue) {
+
+#if ( lockfreeHAS_ATOMICS == 1 )
+  return __atomic_exchange_n(pulTarget, ulValue, __ATOMIC_SEQ_CST);
+#else
+  uint32_t ulStatus = ulIrqMaskSave();
+  uint32_t ulOld = *pulTarget;
+
+  *pulTarget = ulValue;
+  vIrqMaskRestore(ulStatus);
+  return ulOld;
+#endif
+}
+
+
+/******************************************************************************
+ * Atomically replace the value if it equals ulExpected. Returns pdTRUE if it
+ * has been replaced.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) BaseType_t xAtomicCompareAndSwap(volatile uint32_t *pulTarget,
+                                                                              uint32_t ulExpected, uint32_t ulValue) {
+
+#if ( lockfreeHAS_ATOMICS == 1 )
+  return __atomic_compare_exchange_n(pulTarget, &ulExpected, ulValue, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) ? pdTRUE : pdFALSE;
+#else
+  uint32_t ulStatus = ulIrqMaskSave();
+  BaseType_t xResult = pdFALSE;
+
+  if (*pulTarget == ulExpected) {
+    *pulTarget = ulValue;
+    xResult = pdTRUE;
+  }
+  vIrqMaskRestore(ulStatus);
+  return xResult;
+#endif
+}
+
+
+/******************************************************************************
+ * Put a word into an SPSC ring. Returns pdFAIL if the ring is full.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) BaseType_t xSpscRingPush(SpscRing_t *pxRing, uint32_t ulValue) {
+
+  uint32_t ulHead = pxRing->ulHead;
+
+  if ((ulHead - pxRing->ulTail) > pxRing->ulMask) {
+    return pdFAIL;
+  }
+  pxRing->pulSlots[ulHead & pxRing->ulMask] = ulValue;
+  lockfreeFENCE(); // data before index
+  pxRing->ulHead = ulHead + 1;
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Get a word from an SPSC ring. Returns pdFAIL if the ring is empty.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) BaseType_t xSpscRingPop(SpscRing_t *pxRing, uint32_t *pulValue) {
+
+  uint32_t ulTail = pxRing->ulTail;
+
+  if (ulTail == pxRing->ulHead) {
+    return pdFAIL;
+  }
+  lockfreeFENCE(); // index before data
+  *pulValue = pxRing->pulSlots[ulTail & pxRing->ulMask];
+  lockfreeFENCE(); // data before the slot is released
+  pxRing->ulTail = ulTail + 1;
+  return pdPASS;
+}
+
+
+/******************************************************************************
+ * Number of entries in a ring (a snapshot).
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t ulSpscRingCount(const SpscRing_t *pxRing) {
+
+  return pxRing->ulHead - pxRing->ulTail;
+}
+
+static inline __attribute__((always_inline)) uint32_t ulMpscRingCount(const MpscRing_t *pxRing) {
+
+  return pxRing->ulHead - pxRing->ulTail;
+}
+
+#endif /* LOCKFREE_H */
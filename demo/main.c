@@ -36,25 +36,49 @@
 /* NEORV32 HAL */
 #include <neorv32.h>
 
+/* Interrupt-driven UART0 console and deferred logging */
+#include "console.h"
+#include "binlog.h"
+
+/* FIRQ dispatcher and run-time statistics */
+#include "irq.h"
+#include "hrtimer.h"
+#include "dma.h"
+#include "runtime_stats.h"
+#include "stack_monitor.h"
+#include "stack_guard.h"
+#include "cache.h"
+#include "trace.h"
+#include "profiler.h"
+
+/* Runtime hardware discovery and kernel tick */
+#include "platform.h"
+#include "tick.h"
+
 /* Platform UART configuration */
-#define UART_BAUD_RATE (19200)         // transmission speed
-#define UART_HW_HANDLE (NEORV32_UART0) // use UART0 (primary UART)
+#ifndef UART_BAUD_RATE
+  #define UART_BAUD_RATE (19200) // transmission speed; override via USER_FLAGS+=-DUART_BAUD_RATE=...
+#endif
+
+/* Application to run; select via "make APP=..." */
+#ifndef mainAPPLICATION
+  #define mainAPPLICATION blinky
+#endif
 
 /* External definitions */
-extern void blinky(void);                       // actual show-case application
+extern void mainAPPLICATION(void);              // actual show-case application (blinky.c, benchmark.c)
 extern void freertos_risc_v_trap_handler(void); // FreeRTOS core
 
-/* Prototypes for the standard FreeRTOS callback/hook functions implemented
- * within this file. See https://www.freertos.org/a00016.html */
-void vApplicationMallocFailedHook(void);
-void vApplicationIdleHook(void);
-void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName);
-void vApplicationTickHook(void);
+/* The FreeRTOS hooks, vToggleLED() and vSendString() are in hooks.c (shared with the host build) */
 
 /* Platform-specific prototypes */
-void vToggleLED(void);
-void vSendString(const char * pcString);
+void vFaultHalt(void);
+static void prvInitSections(void);
 static void prvSetupHardware(void);
+static void prvGptmrTick(void *pvContext);
+
+/* Demo high-resolution timer */
+static HrTimer_t xGptmrTick;
 
 
 /******************************************************************************
@@ -62,17 +86,30 @@ static void prvSetupHardware(void);
  ******************************************************************************/
 int main( void ) {
 
+  // copy the kernel fast path into IMEM and clear the DMEM scratchpad (if used)
+  prvInitSections();
+
+  // detect clock, memory and ISA extensions and set up the heap (before anything is allocated)
+  vPlatformInit();
+
   // setup hardware
 	prvSetupHardware();
 
   // say hello
-  neorv32_uart_printf(UART_HW_HANDLE, "\n<<< NEORV32 running FreeRTOS %s >>>\n\n", tskKERNEL_VERSION_NUMBER);
+  vConsolePrintf("\n<<< NEORV32 running FreeRTOS %s >>>\n\n", tskKERNEL_VERSION_NUMBER);
+
+  // start the deferred logging task, the CPU load and stack monitors, the trace dump task and the profiler (if enabled)
+  vBinlogInit();
+  vRuntimeStatsMonitorStart();
+  vStackMonitorStart();
+  vTraceInit();
+  vProfilerInit();
 
   // run actual application code
-  blinky();
+  mainAPPLICATION();
 
   // we should never reach this
-  neorv32_uart_printf(UART_HW_HANDLE, "WARNING! blinky returned!\n");
+  vConsolePanicPuts("WARNING! application returned!\n");
   return -1;
 }
 
@@ -81,6 +118,36 @@ int main( void ) {
 // NEORV32-Specific
 //#################################################################################################
 
+/******************************************************************************
+ * Initialize the sections that are not handled by crt0: copy .fast_text from
+ * XIP flash into IMEM (fast_text.ld) and clear the DMEM scratchpad
+ * (scratchpad.ld). Nothing to do for the default memory layout.
+ ******************************************************************************/
+static void prvInitSections(void) {
+
+#if ( configFAST_TEXT_COPY == 1 )
+  extern const uint32_t __fast_text_load[];
+  extern uint32_t __fast_text_start[], __fast_text_end[];
+  const uint32_t *pulSrc = __fast_text_load;
+  uint32_t *pulDst = __fast_text_start;
+
+  while (pulDst < __fast_text_end) {
+    *pulDst++ = *pulSrc++;
+  }
+  vCacheSyncInstructions(); // make sure the instruction fetch sees the new code
+#endif
+
+#if ( configUSE_SCRATCHPAD == 1 )
+  extern uint32_t __scratchpad_start[], __scratchpad_end[];
+  uint32_t *pulWord = __scratchpad_start;
+
+  while (pulWord < __scratchpad_end) {
+    *pulWord++ = 0;
+  }
+#endif
+}
+
+
 /******************************************************************************
  * Setup the hardware for this demo.
  ******************************************************************************/
@@ -93,6 +160,9 @@ static void prvSetupHardware(void) {
   // install the freeRTOS kernel trap handler
   neorv32_cpu_csr_write(CSR_MTVEC, (uint32_t)&freertos_risc_v_trap_handler);
 
+  // enable the PMP stack guard (if enabled); has to be done before any task is created
+  vStackGuardInit();
+
   // ----------------------------------------------------------
   // Peripheral setup
   // ----------------------------------------------------------
@@ -100,100 +170,114 @@ static void prvSetupHardware(void) {
   // clear GPIO.out port
   neorv32_gpio_port_set(0);
 
-  // setup UART0 at default baud rate, no interrupts
-  neorv32_uart_setup(UART_HW_HANDLE, UART_BAUD_RATE, 0);
+  // setup UART0 console (RX/TX interrupts are used once the scheduler is running)
+  vConsoleInit(UART_BAUD_RATE);
 
   // ----------------------------------------------------------
   // Configuration checks
   // ----------------------------------------------------------
 
+  // report caches and check the cache-line alignment
+  vCacheInit();
+
   // CLINT available?
   if (neorv32_clint_available() == 0) {
-    neorv32_uart_printf(UART_HW_HANDLE, "ERROR! CLINT not available!\n");
+    vConsolePuts("ERROR! CLINT not available!\n");
   }
 
   // general purpose timer available?
   if (neorv32_gptmr_available() == 0) {
-    neorv32_uart_printf(UART_HW_HANDLE, "WARNING! GPTMR timer not available!\n");
+    vConsolePuts("WARNING! GPTMR timer not available!\n");
   }
 
-  // check clock frequency configuration
-  uint32_t neorv32_clk_hz = (uint32_t)NEORV32_SYSINFO->CLK;
-  if (neorv32_clk_hz != (uint32_t)configCPU_CLOCK_HZ) {
-    neorv32_uart_printf(UART_HW_HANDLE,
-                        "WARNING! Incorrect 'configCPU_CLOCK_HZ' configuration!\n"
-                        "FreeRTOS configCPU_CLOCK_HZ: %u Hz\n"
-                        "NEORV32 clock speed:         %u Hz\n\n",
-                        (uint32_t)configCPU_CLOCK_HZ, neorv32_clk_hz);
-  }
+  // report the detected configuration (tick, timers and UART baud rate are derived from it)
+  vConsolePrintf("Clock: %u Hz, DMEM: %u bytes, heap: %u bytes, extensions:%s%s\n\n",
+                 ulPlatformClockHz, ulPlatformGetDmemSize(), (uint32_t)xPlatformGetHeapSize(),
+                 (ulPlatformIsa & platformISA_M) ? " M" : "", (ulPlatformIsa & platformISA_ZBB) ? " Zbb" : "");
 
   // ----------------------------------------------------------
-  // Configure general-purpose timer (GPTMR) tick
+  // High-resolution timer service (GPTMR)
   // ----------------------------------------------------------
 
-  if (neorv32_gptmr_available() != 0) { // GPTMR implemented at all?
+  // setup GPTMR and install its interrupt handler (does nothing if there is no GPTMR)
+  vHrTimerServiceInit();
 
-    // configure timer slice 0: continuous mode with clock divider = 64,
-    // fire interrupt every 4 seconds
-    neorv32_gptmr_setup(CLK_PRSC_64);
-    neorv32_gptmr_configure(0, 0, (configCPU_CLOCK_HZ / 64) * 4, 1);
+  // demo timer: fire every 4 seconds
+  vHrTimerInit(&xGptmrTick, prvGptmrTick, NULL);
+  xHrTimerStart(&xGptmrTick, 4000000, 4000000);
 
-    // enable GPTMR interrupt
-    neorv32_cpu_csr_set(CSR_MIE, 1 << GPTMR_FIRQ_ENABLE);
-    neorv32_gptmr_enable_single(0);
-  }
+  // ----------------------------------------------------------
+  // DMA controller
+  // ----------------------------------------------------------
+
+  // enable the DMA and install its completion interrupt handler (if implemented)
+  xDmaInit();
 }
 
 
 /******************************************************************************
  * Handle NEORV32-/application-specific interrupts.
  ******************************************************************************/
-void freertos_risc_v_application_interrupt_handler(void) {
+configFAST_TEXT void freertos_risc_v_application_interrupt_handler(void) {
 
   // mcause identifies the cause of the interrupt
   uint32_t mcause = neorv32_cpu_csr_read(CSR_MCAUSE);
+  // non-zero if this interrupt preempts a handler (configUSE_IRQ_NESTING)
+  uint32_t ulNesting = ulNeorv32IrqNesting;
+
+#if ( configNUMBER_OF_CORES == 1 )
+  // kernel tick (see tick.c)
+  if (mcause == TRAP_CODE_MTI) {
+    vTickInterruptHandler();
+    return;
+  }
+#endif
 
-  if (mcause == GPTMR_TRAP_CODE) { // is GPTMR interrupt
-    neorv32_gptmr_irq_ack(neorv32_gptmr_irq_get()); // clear GPTMR timer-match interrupt
-    neorv32_uart_printf(UART_HW_HANDLE, "GPTMR IRQ Tick\n");
+  // a preempting handler's time is accounted to the preempted one
+  if (ulNesting == 0) {
+    vRuntimeStatsIsrEnter();
   }
-  else { // undefined interrupt cause
-    neorv32_uart_printf(UART_HW_HANDLE, "\n<NEORV32-IRQ> Unexpected IRQ! cause=0x%x </NEORV32-IRQ>\n", mcause); // debug output
+  traceNEORV32_ISR_ENTER(mcause);
+
+  // fast interrupts are dispatched via the handler table (see irq.c)
+  if (xNeorv32IrqDispatch(mcause) == pdFALSE) { // undefined interrupt cause
+    BINLOG_ISR("<NEORV32-IRQ> Unexpected IRQ! cause=0x%x </NEORV32-IRQ>", mcause); // debug output
+  }
+
+  traceNEORV32_ISR_EXIT();
+  if (ulNesting == 0) {
+    vRuntimeStatsIsrExit();
   }
 }
 
 
 /******************************************************************************
- * Handle NEORV32-/application-specific exceptions.
+ * Demo high-resolution timer callback (interrupt context).
  ******************************************************************************/
-void freertos_risc_v_application_exception_handler(void) {
+configFAST_TEXT static void prvGptmrTick(void *pvContext) {
 
-  // mcause identifies the cause of the exception
-  uint32_t mcause = neorv32_cpu_csr_read(CSR_MCAUSE);
-
-  // mepc identifies the address of the exception
-  uint32_t mepc = neorv32_cpu_csr_read(CSR_MEPC);
+  (void)pvContext;
 
-  // debug output
-  neorv32_uart_printf(UART_HW_HANDLE, "\n<NEORV32-EXC> mcause = 0x%x @ mepc = 0x%x </NEORV32-EXC>\n", mcause,mepc); // debug output
+  BINLOG_ISR("GPTMR IRQ Tick");
 }
 
 
 /******************************************************************************
- * Toggle GPIO.out(0) pin.
+ * Handle NEORV32-/application-specific exceptions.
  ******************************************************************************/
-void vToggleLED(void) {
+void freertos_risc_v_application_exception_handler(void) {
 
-	neorv32_gpio_pin_toggle(0);
-}
+  // mcause identifies the cause of the exception
+  uint32_t mcause = neorv32_cpu_csr_read(CSR_MCAUSE);
 
+  // mepc identifies the address of the exception
+  uint32_t mepc = neorv32_cpu_csr_read(CSR_MEPC);
 
-/******************************************************************************
- * Send a plain string via UART0.
- ******************************************************************************/
-void vSendString(const char * pcString) {
+  // stack overflow caught by the PMP stack guard? (does not return then)
+  vStackGuardCheckFault(mcause, neorv32_cpu_csr_read(CSR_MTVAL));
 
-	neorv32_uart_puts(UART_HW_HANDLE, (const char *)pcString);
+  // debug output
+  vConsolePrintf("\n<NEORV32-EXC> mcause = 0x%x @ mepc = 0x%x </NEORV32-EXC>\n", mcause, mepc); // debug output
 }
 
 
@@ -209,13 +293,13 @@ void vAssertCalled(void) {
 	/* Clear all LEDs */
   neorv32_gpio_port_set(0);
 
-  neorv32_uart_puts(UART_HW_HANDLE, "FreeRTOS_FAULT: vAssertCalled called!\n");
+  vConsolePanicPuts("FreeRTOS_FAULT: vAssertCalled called!\n");
 
 	/* Flash the lowest 2 LEDs to indicate that assert was hit - interrupts are off
 	here to prevent any further tick interrupts or context switches, so the
 	delay is implemented as a busy-wait loop instead of a peripheral timer. */
 	while(1) {
-		for (i=0; i<(configCPU_CLOCK_HZ/100); i++) {
+		for (i=0; i<(int)(ulPlatformClockHz/100); i++) {
 			__asm volatile( "nop" );
 		}
 		neorv32_gpio_pin_toggle(0);
@@ -224,89 +308,12 @@ void vAssertCalled(void) {
 }
 
 
-//#################################################################################################
-// FreeRTOS Hooks
-//#################################################################################################
-
-/******************************************************************************
- * Hook for failing malloc.
- ******************************************************************************/
-void vApplicationMallocFailedHook(void) {
-
-	/* vApplicationMallocFailedHook() will only be called if
-	configUSE_MALLOC_FAILED_HOOK is set to 1 in FreeRTOSConfig.h. It is a hook
-	function that will get called if a call to pvPortMalloc() fails.
-	pvPortMalloc() is called internally by the kernel whenever a task, queue,
-	timer or semaphore is created. It is also called by various parts of the
-	demo application. The size of the heap available to pvPortMalloc() is
-	defined by configTOTAL_HEAP_SIZE in FreeRTOSConfig.h. The
-	xPortGetFreeHeapSize() API function can be used to query the size of free
-	heap space that remains (although it does not provide information on how
-	the remaining heap might be fragmented).
-
-	If heap_3.c is used, then configTOTAL_HEAP_SIZE has no effect and the heap
-	size is instead defined by setting the linker variable __neorv32_heap_size.
-	xPortGetFreeHeapSize() cannot be used with heap_3.c. */
-
-	taskDISABLE_INTERRUPTS();
-
-  neorv32_uart_puts(UART_HW_HANDLE,
-                    "FreeRTOS_FAULT: vApplicationMallocFailedHook "
-                    "(increase 'configTOTAL_HEAP_SIZE' in FreeRTOSConfig.h)\n");
-
-	__asm volatile("ebreak"); // trigger context switch
-
-	while(1);
-}
-
-
-/******************************************************************************
- * Hook for the idle process.
- ******************************************************************************/
-void vApplicationIdleHook(void) {
-
-	/* vApplicationIdleHook() will only be called if configUSE_IDLE_HOOK is set
-	to 1 in FreeRTOSConfig.h. It will be called on each iteration of the idle
-	task. It is essential that code added to this hook function never attempts
-	to block in any way (for example, call xQueueReceive() with a block time
-	specified, or call vTaskDelay()). If the application makes use of the
-	vTaskDelete() API function (as this demo application does) then it is also
-	important that vApplicationIdleHook() is permitted to return to its calling
-	function, because it is the responsibility of the idle task to clean up
-	memory allocated by the kernel to any task that has since been deleted. */
-
-  neorv32_cpu_sleep(); // cpu wakes up on any interrupt request
-}
-
-
 /******************************************************************************
- * Hook for task stack overflow.
+ * Stop after a fatal error (FreeRTOS hooks, see hooks.c).
  ******************************************************************************/
-void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
-
-	(void)pcTaskName;
-	(void)pxTask;
-
-	/* Run time stack overflow checking is performed if
-	configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2. This hook
-	function is called if a stack overflow is detected. */
-
-	taskDISABLE_INTERRUPTS();
-
-  neorv32_uart_printf(UART_HW_HANDLE,
-                      "FreeRTOS_FAULT: vApplicationStackOverflowHook "
-                      "(increase 'configISR_STACK_SIZE_WORDS' in FreeRTOSConfig.h)\n");
+void vFaultHalt(void) {
 
 	__asm volatile("ebreak"); // trigger context switch
 
 	while(1);
 }
-
-
-/******************************************************************************
- * Hook for the application tick (unused).
- ******************************************************************************/
-void vApplicationTickHook(void) {
-
-  __asm volatile( "nop" ); // nothing to do here yet
-}
@@ -0,0 +1,157 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Runtime hardware discovery
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Platform API */
+#include "platform.h"
+
+/* Linker symbols: linked RAM (.data, .bss, newlib heap, main stack) */
+extern char __neorv32_ram_base[];
+extern char __neorv32_ram_size[];
+
+/* Detected configuration */
+uint32_t ulPlatformIsa = 0;
+uint32_t ulPlatformClockHz = configCPU_CLOCK_HZ;
+uint32_t ulPlatformCyclesPerUs = 1;
+static uint32_t ulDmemSize = 0;
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+/* Heap regions (heap_5): static heap + unused DMEM beyond the linked RAM */
+static uint8_t ucHeap[configTOTAL_HEAP_SIZE] __attribute__((aligned(16)));
+static HeapRegion_t xHeapRegions[3];
+static size_t xHeapSize = 0;
+
+/* Prototypes */
+static void prvDefineHeapRegions(void);
+#endif
+
+#if !defined(__riscv_zbb)
+/* Replaces the libgcc version (used by __builtin_clz) */
+int __clzsi2(uint32_t ulValue);
+#endif
+
+
+/******************************************************************************
+ * Detect clock, memory and ISA extensions and set up the heap. Has to be
+ * called before the first allocation.
+ ******************************************************************************/
+void vPlatformInit(void) {
+
+  // ISA extensions
+  if (neorv32_cpu_csr_read(CSR_MISA) & (1 << CSR_MISA_M)) {
+    ulPlatformIsa |= platformISA_M;
+  }
+  if (neorv32_cpu_csr_read(CSR_MXISA) & (1 << CSR_MXISA_ZBB)) {
+    ulPlatformIsa |= platformISA_ZBB;
+  }
+
+  // clock; at least 1 cycle per microsecond so the conversions never collapse to zero
+  ulPlatformClockHz = (uint32_t)NEORV32_SYSINFO->CLK;
+  ulPlatformCyclesPerUs = ulPlatformDivU32(ulPlatformClockHz, 1000000);
+  if (ulPlatformCyclesPerUs == 0) {
+    ulPlatformCyclesPerUs = 1;
+  }
+
+  // internal data memory
+  if (NEORV32_SYSINFO->SOC & (1 << SYSINFO_SOC_MEM_INT_DMEM)) {
+    ulDmemSize = (uint32_t)1 << NEORV32_SYSINFO->MISC[SYSINFO_MISC_DMEM];
+  }
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+  prvDefineHeapRegions();
+#endif
+}
+
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+/******************************************************************************
+ * Hand the static heap and all DMEM beyond the linked RAM size to heap_5.
+ * The extra region only exists if the RAM is linked to the DMEM (not with
+ * an external RAM / scratchpad layout) and the DMEM is larger than RAM_SIZE.
+ ******************************************************************************/
+static void prvDefineHeapRegions(void) {
+
+  uint32_t ulRamEnd = (uint32_t)__neorv32_ram_base + (uint32_t)__neorv32_ram_size;
+  uint32_t ulDmemEnd = NEORV32_DMEM_BASE + ulDmemSize;
+  size_t i = 0;
+
+  xHeapRegions[i].pucStartAddress = ucHeap;
+  xHeapRegions[i].xSizeInBytes = sizeof(ucHeap);
+  xHeapSize = sizeof(ucHeap);
+  i++;
+
+  if (((uint32_t)__neorv32_ram_base == NEORV32_DMEM_BASE) && (ulDmemEnd > ulRamEnd)) {
+    xHeapRegions[i].pucStartAddress = (uint8_t *)ulRamEnd;
+    xHeapRegions[i].xSizeInBytes = ulDmemEnd - ulRamEnd;
+    xHeapSize += ulDmemEnd - ulRamEnd;
+    i++;
+  }
+
+  // terminator
+  xHeapRegions[i].pucStartAddress = NULL;
+  xHeapRegions[i].xSizeInBytes = 0;
+
+  vPortDefineHeapRegions(xHeapRegions);
+}
+#endif
+
+
+/******************************************************************************
+ * Get the size of the internal DMEM in bytes (0 if not implemented).
+ ******************************************************************************/
+uint32_t ulPlatformGetDmemSize(void) {
+
+  return ulDmemSize;
+}
+
+
+/******************************************************************************
+ * Get the total size of all heap regions in bytes (0 without a heap).
+ ******************************************************************************/
+size_t xPlatformGetHeapSize(void) {
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+  return xHeapSize;
+#else
+  return 0;
+#endif
+}
+
+
+#if !defined(__riscv_zbb)
+/******************************************************************************
+ * Count leading zeros. The kernel uses __builtin_clz() to find the highest
+ * ready priority (configUSE_PORT_OPTIMISED_TASK_SELECTION) on every context
+ * switch; without Zbb in the ISA string GCC calls this function. Executes
+ * the Zbb clz instruction if the CPU has it, otherwise a branch-free binary
+ * search (constant time, no table). Returns 32 for 0.
+ ******************************************************************************/
+configFAST_TEXT int __clzsi2(uint32_t ulValue) {
+
+  uint32_t ulZeros, ulShift;
+
+  if (ulPlatformIsa & platformISA_ZBB) {
+    __asm (".insn i 0x13, 1, %0, %1, 0x600" : "=r" (ulZeros) : "r" (ulValue)); // clz
+    return (int)ulZeros;
+  }
+
+  ulShift = (uint32_t)(ulValue < 0x00010000u) << 4; ulZeros  = ulShift; ulValue <<= ulShift;
+  ulShift = (uint32_t)(ulValue < 0x01000000u) << 3; ulZeros += ulShift; ulValue <<= ulShift;
+  ulShift = (uint32_t)(ulValue < 0x10000000u) << 2; ulZeros += ulShift; ulValue <<= ulShift;
+  ulShift = (uint32_t)(ulValue < 0x40000000u) << 1; ulZeros += ulShift; ulValue <<= ulShift;
+  ulShift = (uint32_t)(ulValue < 0x80000000u);      ulZeros += ulShift; ulValue <<= ulShift;
+  return (int)(ulZeros + (uint32_t)(ulValue == 0));
+}
+#endif
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Runtime hardware discovery
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * One firmware image runs on processors with different clocks, memory sizes
+ * and ISA extensions. vPlatformInit() reads the configuration from SYSINFO
+ * and the ISA CSRs at boot:
+ *
+ * - clock: ulPlatformClockHz holds SYSINFO->CLK; the tick (tick.c), the
+ *   high-resolution timers and the UART baud divisor (HAL) are derived from
+ *   it at run time. configCPU_CLOCK_HZ stays a compile-time constant (the
+ *   generic port uses it in static initializers) and is only the default
+ *   until vPlatformInit() has run
+ * - memory: the heap (heap_5) consists of configTOTAL_HEAP_SIZE bytes in
+ *   .bss plus all internal DMEM beyond the linked RAM size (RAM_SIZE in the
+ *   makefile is the smallest DMEM the image has to run on)
+ * - ISA: if the image is built without the M extension but the CPU has it,
+ *   the helpers below execute the M instructions anyway; the kernel's
+ *   ready-list lookup uses the Zbb clz instruction if available (__clzsi2)
+ *
+ * vPlatformInit() has to be called before anything is allocated.
+ ******************************************************************************/
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Detected ISA extensions */
+#define platformISA_M       ( 1u << 0 )
+#define platformISA_ZBB     ( 1u << 1 )
+
+/* Detected configuration (valid after vPlatformInit()) */
+extern uint32_t ulPlatformIsa;
+extern uint32_t ulPlatformClockHz;
+extern uint32_t ulPlatformCyclesPerUs;
+
+void vPlatformInit(void);
+uint32_t ulPlatformGetDmemSize(void);
+size_t xPlatformGetHeapSize(void);
+
+
+/******************************************************************************
+ * 32 x 32 -> 64 bit unsigned multiplication (mul/mulhu if available).
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint64_t ullPlatformMulU32(uint32_t ulA, uint32_t ulB) {
+
+#if !defined(__riscv_mul)
+  uint32_t ulLow, ulHigh;
+
+  if (ulPlatformIsa & platformISA_M) {
+    __asm (".insn r 0x33, 0, 1, %0, %1, %2" : "=r" (ulLow) : "r" (ulA), "r" (ulB));  // mul
+    __asm (".insn r 0x33, 3, 1, %0, %1, %2" : "=r" (ulHigh) : "r" (ulA), "r" (ulB)); // mulhu
+    return ((uint64_t)ulHigh << 32) | ulLow;
+  }
+#endif
+  return (uint64_t)ulA * ulB;
+}
+
+
+/******************************************************************************
+ * 32-bit unsigned division (divu if available).
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t ulPlatformDivU32(uint32_t ulA, uint32_t ulB) {
+
+#if !defined(__riscv_div)
+  uint32_t ulQuotient;
+
+  if (ulPlatformIsa & platformISA_M) {
+    __asm (".insn r 0x33, 5, 1, %0, %1, %2" : "=r" (ulQuotient) : "r" (ulA), "r" (ulB)); // divu
+    return ulQuotient;
+  }
+#endif
+  return ulA / ulB;
+}
+
+#endif /* PLATFORM_H */
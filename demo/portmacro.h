@@ -0,0 +1,54 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Port macro overrides for interrupt nesting
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * This header is found before the port's own portmacro.h (the demo folder is
+ * the first include path) and includes it unchanged. With interrupt nesting
+ * (configUSE_IRQ_NESTING, irq.c) a handler can be preempted by a handler of
+ * a higher priority, so the kernel's interrupt-safe critical sections have
+ * to mask interrupts; the generic RISC-V port defines them empty as it never
+ * nests interrupts:
+ *
+ * - portSET/CLEAR_INTERRUPT_MASK_FROM_ISR() clear/restore mstatus.MIE, so
+ *   the FromISR API can be used at every priority
+ * - portEND_SWITCHING_ISR() / portYIELD_FROM_ISR() call vTaskSwitchContext()
+ *   with interrupts masked
+ *
+ * Both cost a single CSR access each when interrupts are already disabled
+ * (irq_mask.h).
+ ******************************************************************************/
+
+#ifndef NEORV32_PORTMACRO_H
+#define NEORV32_PORTMACRO_H
+
+#include_next "portmacro.h"
+#include "irq_mask.h"
+
+#if defined(configUSE_IRQ_NESTING) && ( configUSE_IRQ_NESTING == 1 ) && !defined(__ASSEMBLER__)
+
+#undef portSET_INTERRUPT_MASK_FROM_ISR
+#undef portCLEAR_INTERRUPT_MASK_FROM_ISR
+#undef portEND_SWITCHING_ISR
+#undef portYIELD_FROM_ISR
+
+#define portSET_INTERRUPT_MASK_FROM_ISR()             ( ( UBaseType_t ) ulIrqMaskSave() )
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( uxStatus ) vIrqMaskRestore( ( uint32_t ) ( uxStatus ) )
+
+#define portEND_SWITCHING_ISR( xSwitchRequired )                          \
+  do {                                                                    \
+    if( ( xSwitchRequired ) != pdFALSE ) {                                \
+      uint32_t ulSwitchStatus = ulIrqMaskSave();                          \
+      traceISR_EXIT_TO_SCHEDULER();                                       \
+      vTaskSwitchContext();                                               \
+      vIrqMaskRestore( ulSwitchStatus );                                  \
+    }                                                                     \
+    else {                                                                \
+      traceISR_EXIT();                                                    \
+    }                                                                     \
+  } while( 0 )
+#define portYIELD_FROM_ISR( x )                       portEND_SWITCHING_ISR( x )
+
+#endif /* configUSE_IRQ_NESTING */
+
+#endif /* NEORV32_PORTMACRO_H */
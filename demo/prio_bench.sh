@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+
+# Measure the scheduler's task selection (benchmark.c: ctx_select, ctx_yield)
+# for different numbers of priorities, with the generic C selection and with
+# the port-optimised clz selection, for the given build profiles.
+#   PRIORITIES="5 8 16 32" prio_bench.sh [profile ...]
+
+set -e
+
+cd $(dirname "$0")
+
+PROFILES=${@:-default rv32imc_zbb}
+PRIORITIES=${PRIORITIES:-"5 8 16 32"}
+REPORT=""
+
+for p in $PROFILES; do
+  for n in $PRIORITIES; do
+    for sel in 0 1; do
+      make USER_FLAGS+="-DUART0_SIM_MODE -DconfigMAX_PRIORITIES=$n -DconfigUSE_PORT_OPTIMISED_TASK_SELECTION=$sel" \
+           APP=benchmark PROFILE=$p clean_all exe install
+      make -i GHDL_RUN_FLAGS="--stop-time=10ms" sim
+
+      # minimum cycles
+      select=$(grep -a '#BENCH:ctx_select ' ../neorv32/sim/ghdl.log | tail -n 1 | awk '{print $2}')
+      yield=$(grep -a '#BENCH:ctx_yield ' ../neorv32/sim/ghdl.log | tail -n 1 | awk '{print $2}')
+      zbb=$(grep -a '#BENCH-CFG:' ../neorv32/sim/ghdl.log | tail -n 1 | sed -n 's/.*zbb=\([01]\).*/\1/p')
+
+      [ "$sel" = "1" ] && name="clz" || name="generic"
+      REPORT+=$(printf "%-12s %10s %-8s %4s %10s %9s" "$p" "$n" "$name" "${zbb:--}" "${select:--}" "${yield:--}")$'\n'
+    done
+  done
+done
+
+echo ""
+printf "%-12s %10s %-8s %4s %10s %9s\n" "profile" "priorities" "select" "zbb" "ctx_select" "ctx_yield"
+printf "%s" "$REPORT"
@@ -0,0 +1,221 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Statistical PC-sampling profiler
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Profiler, GPTMR sharing, FIRQ dispatcher and console */
+#include "profiler.h"
+#include "hrtimer.h"
+#include "irq.h"
+#include "console.h"
+#include "platform.h"
+
+#if ( configUSE_PROFILER == 1 )
+
+#if ((configPROFILER_BUCKETS & (configPROFILER_BUCKETS - 1)) != 0)
+  #error "configPROFILER_BUCKETS has to be a power of two!"
+#endif
+#if ( configPROFILER_RATE_HZ < 1 ) || ( configPROFILER_RATE_HZ > 10000 )
+  #error "configPROFILER_RATE_HZ has to be in the range 1..10000!"
+#endif
+#if ( configPROFILER_MAX_TASKS > profilerTASK_OTHER )
+  #error "configPROFILER_MAX_TASKS is too large!"
+#endif
+
+/* Buckets probed before a sample is dropped */
+#define profilerMAX_PROBES    ( 8 )
+
+/* Sample count in the info word */
+#define profilerCOUNT_ONE     ( 0x100u )
+#define profilerCOUNT_MAX     ( 0xffffff00u )
+
+/* Histogram bucket (ulInfo = 0: free) */
+typedef struct {
+  uint32_t ulPc;
+  uint32_t ulInfo;               // task index (bits 7:0) | samples (bits 31:8)
+} ProfilerBucket_t;
+
+/* Histogram and the tasks seen since the last dump; the name is copied when a task is sampled for the
+ * first time (it is certainly alive then, it might be deleted before the dump) */
+static ProfilerBucket_t xBuckets[configPROFILER_BUCKETS];
+static TaskHandle_t xTasks[configPROFILER_MAX_TASKS];
+static char cTaskNames[configPROFILER_MAX_TASKS][configMAX_TASK_NAME_LEN];
+static uint32_t ulTaskCount = 0;
+
+/* Statistics since the last dump */
+static volatile uint32_t ulSamples = 0;
+static volatile uint32_t ulLost = 0;
+static volatile uint32_t ulEnabled = 0;
+
+/* Prototypes */
+static uint32_t prvTaskIndex(void);
+static void prvProfilerSample(void *pvContext);
+#if ( configPROFILER_DUMP_PERIOD_MS > 0 )
+static void prvProfilerTask(void *pvParameters);
+#endif
+
+
+/******************************************************************************
+ * Start sampling and create the periodic dump task (if enabled). Has to be
+ * called after the timer service has been set up.
+ ******************************************************************************/
+void vProfilerInit(void) {
+
+  if (xHrTimerAttachSlice(configPROFILER_GPTMR_SLICE, prvProfilerSample, NULL) == pdFAIL) {
+    vConsolePuts("WARNING! Profiler: GPTMR slice not available!\n");
+    return;
+  }
+
+  // the slice counts at CLK / hrtimerCLOCK_DIV (hrtimerPRESCALER, shared with the timer service); it starts
+  // counting at 0 and reloads continuously
+  ulEnabled = 1;
+  neorv32_gptmr_configure(configPROFILER_GPTMR_SLICE, 0,
+                          ulPlatformClockHz / (hrtimerCLOCK_DIV * configPROFILER_RATE_HZ), 1);
+  neorv32_gptmr_enable_single(configPROFILER_GPTMR_SLICE);
+
+#if ( configPROFILER_DUMP_PERIOD_MS > 0 )
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  static StaticTask_t xProfilerTCB configSTATIC_DATA;
+  static StackType_t xProfilerStack[configMINIMAL_STACK_SIZE] configSTATIC_DATA;
+  xTaskCreateStatic(prvProfilerTask, "Profiler", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1,
+                    xProfilerStack, &xProfilerTCB);
+#else
+  xTaskCreate(prvProfilerTask, "Profiler", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL);
+#endif
+#endif
+}
+
+
+/******************************************************************************
+ * Index of the interrupted task (interrupt context).
+ ******************************************************************************/
+configFAST_TEXT static uint32_t prvTaskIndex(void) {
+
+  TaskHandle_t xTask;
+  uint32_t i;
+
+#if ( configUSE_IRQ_NESTING == 1 )
+  if (ulNeorv32IrqNesting > 1) { // the GPTMR handler itself is level 1
+    return profilerTASK_ISR;
+  }
+#endif
+
+  xTask = xTaskGetCurrentTaskHandle();
+  for (i = 0; i < ulTaskCount; i++) {
+    if (xTasks[i] == xTask) {
+      return i;
+    }
+  }
+  if (ulTaskCount < configPROFILER_MAX_TASKS) {
+    xTasks[ulTaskCount] = xTask;
+    strncpy(cTaskNames[ulTaskCount], pcTaskGetName(xTask), configMAX_TASK_NAME_LEN - 1);
+    cTaskNames[ulTaskCount][configMAX_TASK_NAME_LEN - 1] = '\0';
+    return ulTaskCount++;
+  }
+  return profilerTASK_OTHER;
+}
+
+
+/******************************************************************************
+ * GPTMR slice interrupt: count the interrupted PC / task.
+ ******************************************************************************/
+configFAST_TEXT static void prvProfilerSample(void *pvContext) {
+
+#if ( configUSE_IRQ_NESTING == 1 )
+  uint32_t ulPc = ulNeorv32IrqMepc; // mepc itself may have been overwritten by a nested trap meanwhile
+#else
+  uint32_t ulPc = neorv32_cpu_csr_read(CSR_MEPC);
+#endif
+  uint32_t ulTask, ulHash, i;
+  ProfilerBucket_t *pxBucket;
+
+  (void)pvContext;
+
+  if (ulEnabled == 0) {
+    return;
+  }
+  ulSamples++;
+
+  ulTask = prvTaskIndex();
+  ulHash = (ulPc >> 1) ^ (ulPc >> 9) ^ (ulTask << 4);
+
+  for (i = 0; i < profilerMAX_PROBES; i++) {
+    pxBucket = &xBuckets[(ulHash + i) & (configPROFILER_BUCKETS - 1)];
+    if (pxBucket->ulInfo == 0) {
+      pxBucket->ulPc = ulPc;
+      pxBucket->ulInfo = profilerCOUNT_ONE | ulTask;
+      return;
+    }
+    if ((pxBucket->ulPc == ulPc) && ((pxBucket->ulInfo & 0xffu) == ulTask)) {
+      if (pxBucket->ulInfo < profilerCOUNT_MAX) {
+        pxBucket->ulInfo += profilerCOUNT_ONE;
+      }
+      return;
+    }
+  }
+  ulLost++;
+}
+
+
+/******************************************************************************
+ * Print the task names and all histogram buckets, then clear the histogram.
+ * Sampling is paused while dumping. Must be called from a task.
+ ******************************************************************************/
+void vProfilerDump(void) {
+
+  uint32_t ulUsed = 0, i;
+
+  ulEnabled = 0;
+
+  vConsolePrintfBlocking("#PFC:%u %u %u %u\n", (unsigned)ulPlatformClockHz, (unsigned)configPROFILER_RATE_HZ,
+                         (unsigned)ulSamples, (unsigned)ulLost);
+
+  for (i = 0; i < ulTaskCount; i++) {
+    vConsolePrintfBlocking("#PFT:%u %08x %s\n", (unsigned)i, (unsigned)xTasks[i], cTaskNames[i]);
+  }
+
+  for (i = 0; i < configPROFILER_BUCKETS; i++) {
+    if (xBuckets[i].ulInfo != 0) {
+      vConsolePrintfBlocking("#PF:%08x %u %u\n", (unsigned)xBuckets[i].ulPc, (unsigned)(xBuckets[i].ulInfo & 0xffu),
+                             (unsigned)(xBuckets[i].ulInfo >> 8));
+      xBuckets[i].ulInfo = 0;
+      ulUsed++;
+    }
+  }
+  vConsolePrintfBlocking("#PFE:%u\n", (unsigned)ulUsed);
+
+  ulTaskCount = 0;
+  ulSamples = 0;
+  ulLost = 0;
+  ulEnabled = 1;
+}
+
+
+#if ( configPROFILER_DUMP_PERIOD_MS > 0 )
+/******************************************************************************
+ * Profiler task: periodically dump the histogram.
+ ******************************************************************************/
+static void prvProfilerTask(void *pvParameters) {
+
+  (void)pvParameters;
+
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(configPROFILER_DUMP_PERIOD_MS));
+    vProfilerDump();
+  }
+}
+#endif
+
+#endif /* configUSE_PROFILER */
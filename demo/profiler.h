@@ -0,0 +1,50 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Statistical PC-sampling profiler
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * A GPTMR slice (configPROFILER_GPTMR_SLICE) interrupts the CPU at
+ * configPROFILER_RATE_HZ. Every sample takes the interrupted program counter
+ * (mepc) and the running task and counts it in a small open-addressing hash
+ * table in RAM (configPROFILER_BUCKETS buckets of 8 bytes):
+ *
+ *   word 0: program counter
+ *   word 1: task index (bits 7:0) | number of samples (bits 31:8)
+ *
+ * Samples that do not find a free bucket within a few probes are only
+ * counted as lost. With interrupt nesting (configUSE_IRQ_NESTING) samples
+ * that interrupt another handler are counted for a pseudo task "(ISR)".
+ * Code that runs with interrupts disabled (critical sections, handlers
+ * without nesting) is not sampled; its samples show up on the instruction
+ * that re-enables interrupts.
+ *
+ * vProfilerDump() prints and clears the table as "#PF" lines via the console
+ * (or into the GHDL simulation log); configPROFILER_DUMP_PERIOD_MS creates a
+ * task that dumps periodically. tools/profile.py symbolizes the samples with
+ * main.elf and prints flat and per-task profiles.
+ ******************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+
+#if ( configUSE_PROFILER == 1 )
+
+/* Pseudo task indices (keep in sync with tools/profile.py) */
+#define profilerTASK_OTHER              ( 0xfe ) // task table full
+#define profilerTASK_ISR                ( 0xff ) // interrupted another handler
+
+void vProfilerInit(void);
+void vProfilerDump(void);
+
+#else
+
+#define vProfilerInit()
+
+#endif /* configUSE_PROFILER */
+
+#endif /* PROFILER_H */
@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+
+# Build the kernel micro-benchmarks (benchmark.c) for all build profiles (or
+# the ones given as arguments), run them in simulation and report code size
+# and context switch costs for each profile.
+#   profiles.sh [profile ...]
+
+set -e
+
+cd $(dirname "$0")
+
+PROFILES=${@:-default rv32imc rv32emc rv32imc_zbb rv32emc_zbb}
+RISCV_PREFIX=${RISCV_PREFIX:-riscv-none-elf-}
+REPORT=""
+
+for p in $PROFILES; do
+  make USER_FLAGS+="-DUART0_SIM_MODE" APP=benchmark PROFILE=$p clean_all exe install
+  make -i GHDL_RUN_FLAGS="--stop-time=10ms" sim
+
+  # text/data/bss of the executable
+  size=$(${RISCV_PREFIX}size main.elf | tail -n 1 | awk '{printf "%8s %6s %6s", $1, $2, $3}')
+
+  # minimum cycles of the context switch benchmarks
+  yield=$(grep -a '#BENCH:ctx_yield ' ../neorv32/sim/ghdl.log | tail -n 1 | awk '{print $2}')
+  preempt=$(grep -a '#BENCH:ctx_preempt ' ../neorv32/sim/ghdl.log | tail -n 1 | awk '{print $2}')
+
+  REPORT+=$(printf "%-12s %s %9s %11s" "$p" "$size" "${yield:--}" "${preempt:--}")$'\n'
+done
+
+echo ""
+printf "%-12s %8s %6s %6s %9s %11s\n" "profile" "text" "data" "bss" "ctx_yield" "ctx_preempt"
+printf "%s" "$REPORT"
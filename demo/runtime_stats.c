@@ -0,0 +1,172 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Run-time statistics and CPU load monitor
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Run-time statistics and console */
+#include "runtime_stats.h"
+#include "stack_guard.h"
+#include "console.h"
+#include "platform.h"
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+/* Time spent in the application interrupt handler */
+uint32_t ulRuntimeStatsIsrStart = 0;
+uint64_t ullRuntimeStatsIsrTime = 0;
+
+/* Snapshot of the previous report to compute the load of the last period */
+static TaskStatus_t xTaskStatus[configSTATS_MONITOR_MAX_TASKS];
+static struct {
+  UBaseType_t xTaskNumber;
+  uint64_t ullRunTime;
+} xHistory[configSTATS_MONITOR_MAX_TASKS];
+static UBaseType_t uxHistoryEntries = 0;
+static uint64_t ullLastTotal = 0, ullLastIsr = 0;
+
+/* Prototypes */
+static uint32_t prvPermille(uint64_t ullDelta, uint32_t ulScale);
+#if ( configUSE_STATS_MONITOR == 1 )
+static void prvMonitorTask(void *pvParameters);
+#endif
+
+
+/******************************************************************************
+ * Get the 64-bit run-time counter (portGET_RUN_TIME_COUNTER_VALUE).
+ ******************************************************************************/
+uint64_t ullRuntimeStatsGetCounter(void) {
+
+#if ( configRUN_TIME_STATS_USE_MCYCLE == 1 )
+  return neorv32_cpu_get_cycle();
+#else
+  return neorv32_clint_time_get();
+#endif
+}
+
+
+/******************************************************************************
+ * Get the increment rate of the run-time counter in Hz. Both, MTIME and
+ * mcycle, are incremented with the processor clock.
+ ******************************************************************************/
+uint32_t ulRuntimeStatsGetCounterRate(void) {
+
+  return ulPlatformClockHz;
+}
+
+
+/******************************************************************************
+ * Convert a counter delta into per mille of the reporting period.
+ ******************************************************************************/
+static uint32_t prvPermille(uint64_t ullDelta, uint32_t ulScale) {
+
+  uint32_t ulPermille = (uint32_t)ullDelta / ulScale;
+  return (ulPermille > 1000) ? 1000 : ulPermille;
+}
+
+
+/******************************************************************************
+ * Print the CPU load of each task and of the interrupt handler since the
+ * last report. The reporting period has to be shorter than 2^32 counter
+ * ticks (~42s at 100MHz).
+ ******************************************************************************/
+void vRuntimeStatsReport(void) {
+
+  static const char cStateNames[] = "XRBSD?";
+  configRUN_TIME_COUNTER_TYPE ullTotal = 0;
+  uint64_t ullLast, ullIsr;
+  UBaseType_t uxTasks, i, j;
+  uint32_t ulScale, ulPermille, ulGuard;
+
+  ulGuard = ulStackGuardSuspend(); // the high-water mark scan reads the caller's guard area
+  uxTasks = uxTaskGetSystemState(xTaskStatus, configSTATS_MONITOR_MAX_TASKS, &ullTotal);
+  vStackGuardResume(ulGuard);
+  ullIsr = ullRuntimeStatsIsrTime;
+
+  // status buffer too small: keep the history of the last complete report
+  if (uxTasks == 0) {
+    vConsolePrintfBlocking("WARNING! increase 'configSTATS_MONITOR_MAX_TASKS'\n");
+    return;
+  }
+
+  ulScale = (uint32_t)(ullTotal - ullLastTotal) / 1000;
+  if (ulScale == 0) {
+    ulScale = 1;
+  }
+
+  vConsolePrintfBlocking("\n--- CPU load (%u ms) ---\nTask             State Prio   CPU\n",
+                         (uint32_t)(ullTotal - ullLastTotal) / (ulPlatformClockHz / 1000));
+
+  for (i = 0; i < uxTasks; i++) {
+    ullLast = 0;
+    for (j = 0; j < uxHistoryEntries; j++) {
+      if (xHistory[j].xTaskNumber == xTaskStatus[i].xTaskNumber) {
+        ullLast = xHistory[j].ullRunTime;
+        break;
+      }
+    }
+    ulPermille = prvPermille(xTaskStatus[i].ulRunTimeCounter - ullLast, ulScale);
+    vConsolePrintfBlocking("%-16s %c     %4u  %3u.%u%%\n", xTaskStatus[i].pcTaskName,
+                           cStateNames[(xTaskStatus[i].eCurrentState < 5) ? xTaskStatus[i].eCurrentState : 5],
+                           (uint32_t)xTaskStatus[i].uxCurrentPriority, ulPermille / 10, ulPermille % 10);
+  }
+
+  ulPermille = prvPermille(ullIsr - ullLastIsr, ulScale);
+  vConsolePrintfBlocking("(FIRQ handlers)              %3u.%u%%\n", ulPermille / 10, ulPermille % 10);
+
+  // remember counters for the next period
+  for (i = 0; i < uxTasks; i++) {
+    xHistory[i].xTaskNumber = xTaskStatus[i].xTaskNumber;
+    xHistory[i].ullRunTime = xTaskStatus[i].ulRunTimeCounter;
+  }
+  uxHistoryEntries = uxTasks;
+  ullLastTotal = ullTotal;
+  ullLastIsr = ullIsr;
+}
+
+
+#if ( configUSE_STATS_MONITOR == 1 )
+/******************************************************************************
+ * Monitor task: periodically print the CPU load.
+ ******************************************************************************/
+static void prvMonitorTask(void *pvParameters) {
+
+  TickType_t xLastWakeTime = xTaskGetTickCount();
+
+  (void)pvParameters;
+
+  for (;;) {
+    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(configSTATS_MONITOR_PERIOD_MS));
+    vRuntimeStatsReport();
+  }
+}
+#endif
+
+
+/******************************************************************************
+ * Create the monitor task (if enabled).
+ ******************************************************************************/
+void vRuntimeStatsMonitorStart(void) {
+
+#if ( configUSE_STATS_MONITOR == 1 )
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  static StaticTask_t xMonitorTCB configSTATIC_DATA;
+  static StackType_t xMonitorStack[configMINIMAL_STACK_SIZE] configSTATIC_DATA;
+  xTaskCreateStatic(prvMonitorTask, "Mon", configMINIMAL_STACK_SIZE, NULL, configSTATS_MONITOR_PRIORITY, xMonitorStack, &xMonitorTCB);
+#else
+  xTaskCreate(prvMonitorTask, "Mon", configMINIMAL_STACK_SIZE, NULL, configSTATS_MONITOR_PRIORITY, NULL);
+#endif
+#endif
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Run-time statistics and CPU load monitor
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * The kernel's run-time statistics (configGENERATE_RUN_TIME_STATS) are based
+ * on a free-running 64-bit counter: the CLINT MTIME timer (default; keeps
+ * running while the CPU sleeps) or the CPU cycle counter mcycle[h]
+ * (configRUN_TIME_STATS_USE_MCYCLE). Using a 64-bit counter the accumulated
+ * per-task times never overflow.
+ *
+ * Additionally, the time spent in the application interrupt handler (all
+ * FIRQs) is accumulated. Note that the kernel attributes this time to the
+ * interrupted task as well.
+ *
+ * If configUSE_STATS_MONITOR is enabled a monitor task periodically prints
+ * the per-task CPU load of the last period via the console.
+ ******************************************************************************/
+
+#ifndef RUNTIME_STATS_H
+#define RUNTIME_STATS_H
+
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+extern uint32_t ulRuntimeStatsIsrStart;
+extern uint64_t ullRuntimeStatsIsrTime;
+
+uint64_t ullRuntimeStatsGetCounter(void);
+uint32_t ulRuntimeStatsGetCounterRate(void);
+void vRuntimeStatsReport(void);
+void vRuntimeStatsMonitorStart(void);
+
+
+/******************************************************************************
+ * Low word of the run-time counter (for measuring short intervals).
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t ulRuntimeStatsGetCounterLow(void) {
+
+#if ( configRUN_TIME_STATS_USE_MCYCLE == 1 )
+  return neorv32_cpu_csr_read(CSR_MCYCLE);
+#else
+  return *(volatile uint32_t *)(configMTIME_BASE_ADDRESS);
+#endif
+}
+
+
+/******************************************************************************
+ * Mark entry / exit of the application interrupt handler.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vRuntimeStatsIsrEnter(void) {
+
+  ulRuntimeStatsIsrStart = ulRuntimeStatsGetCounterLow();
+}
+
+static inline __attribute__((always_inline)) void vRuntimeStatsIsrExit(void) {
+
+  ullRuntimeStatsIsrTime += (uint32_t)(ulRuntimeStatsGetCounterLow() - ulRuntimeStatsIsrStart);
+}
+
+#else
+
+#define vRuntimeStatsIsrEnter()
+#define vRuntimeStatsIsrExit()
+#define vRuntimeStatsMonitorStart()
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+
+#endif /* RUNTIME_STATS_H */
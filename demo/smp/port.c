@@ -0,0 +1,379 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * SMP port for the dual-core NEORV32 ("make SMP=1")
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Detected clock */
+#include "platform.h"
+
+#if (configNUMBER_OF_CORES != 2)
+  #error "The NEORV32 SMP port requires configNUMBER_OF_CORES = 2!"
+#endif
+
+#if (configUSE_TICKLESS_IDLE != 0) || (configUSE_PMP_STACK_GUARD != 0) || (configUSE_TRACE_RECORDER != 0)
+  #error "Tickless idle, the PMP stack guard and the trace recorder are single-core only!"
+#endif
+
+/* Trap causes */
+#define portMCAUSE_ECALL_M    (11u)
+#define portMCAUSE_MSI        (0x80000003u)
+#define portMCAUSE_MTI        (0x80000007u)
+
+/* Initial mstatus of a task: return to machine mode with interrupts enabled (MPP = 11, MPIE = 1) */
+#define portINITIAL_MSTATUS   (0x00001880u)
+
+/* Task context (portASM.S): mepc, mstatus, x1, x5..x31 (x5..x15 for RV32E); 16-byte aligned */
+#ifdef __riscv_32e
+  #define portCONTEXT_WORDS   (16)
+#else
+  #define portCONTEXT_WORDS   (32)
+#endif
+#define portCONTEXT_A0        (3 + (10 - 5))
+
+/* The kernel tick is generated by this hart */
+#define portTICK_CORE         (0)
+
+/* CLINT */
+#define portMSIP(xCoreID)     ((volatile uint32_t *)(configMSIP_BASE_ADDRESS))[(xCoreID)]
+#define portMTIMECMP(xCoreID) ((volatile uint32_t *)(NEORV32_CLINT_BASE + 0x4000u + (8 * (xCoreID))))
+#define portMTIME             ((volatile uint32_t *)(configMTIME_BASE_ADDRESS))
+
+/* External functions */
+extern void freertos_risc_v_trap_handler(void);
+extern void freertos_risc_v_application_interrupt_handler(void);
+extern void freertos_risc_v_application_exception_handler(void);
+extern void xPortStartFirstTask(void);
+
+/* Prototypes */
+void vPortTrapHandler(uint32_t ulCause);
+static void prvTaskExitError(void);
+static void prvTickInterrupt(BaseType_t xCoreID);
+static void prvSetupTimerInterrupt(void);
+static int prvSecondaryCoreMain(void);
+static inline uint32_t prvTryLock(PortRecursiveLock_t *pxLock, uint32_t ulCoreID);
+static inline void prvUnlock(PortRecursiveLock_t *pxLock, uint32_t ulCoreID);
+
+/* Per-hart state */
+volatile UBaseType_t uxPortCriticalNesting[configNUMBER_OF_CORES] = { 0 };
+volatile UBaseType_t uxPortInterruptNesting[configNUMBER_OF_CORES] = { 0 };
+static uint64_t ullNextTime = 0;
+
+/* Kernel locks */
+PortRecursiveLock_t xPortTaskLock = { 0 };
+PortRecursiveLock_t xPortIsrLock = { 0 };
+
+/* Interrupt stacks, one per hart; xISRStackTop is hart 0's (used by the stack monitor) */
+static __attribute__((aligned(16))) StackType_t xISRStack[configNUMBER_OF_CORES][configISR_STACK_SIZE_WORDS];
+StackType_t xPortIsrStackTops[configNUMBER_OF_CORES];
+const StackType_t xISRStackTop = (StackType_t)&(xISRStack[0][configISR_STACK_SIZE_WORDS]);
+
+/* Start-up stack of hart 1 (only used until it starts its first task) */
+static uint8_t ucSecondaryBootStack[256] __attribute__((aligned(16)));
+
+/* Timer increment per tick (from the clock detected at run time) */
+static size_t uxTimerIncrementsForOneTick = 0;
+
+
+/******************************************************************************
+ * Set up the initial context of a task (see portASM.S for the layout).
+ ******************************************************************************/
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters) {
+
+  pxTopOfStack -= portCONTEXT_WORDS;
+  memset(pxTopOfStack, 0, portCONTEXT_WORDS * sizeof(StackType_t));
+
+  pxTopOfStack[0] = (StackType_t)pxCode;           // mepc
+  pxTopOfStack[1] = portINITIAL_MSTATUS;           // mstatus
+  pxTopOfStack[2] = (StackType_t)prvTaskExitError; // x1 (ra)
+  pxTopOfStack[portCONTEXT_A0] = (StackType_t)pvParameters;
+
+  return pxTopOfStack;
+}
+
+
+/******************************************************************************
+ * Tasks must not return.
+ ******************************************************************************/
+static void prvTaskExitError(void) {
+
+  configASSERT(0);
+  portDISABLE_INTERRUPTS();
+  for (;;) {
+  }
+}
+
+
+/******************************************************************************
+ * Trap handler (called by portASM.S on this hart's ISR stack after the
+ * context of the current task has been saved).
+ ******************************************************************************/
+void vPortTrapHandler(uint32_t ulCause) {
+
+  BaseType_t xCoreID = portGET_CORE_ID();
+
+  // environment call: yield
+  if (ulCause == portMCAUSE_ECALL_M) {
+    vTaskSwitchContext(xCoreID);
+    return;
+  }
+
+  uxPortInterruptNesting[xCoreID]++;
+
+  if (ulCause == portMCAUSE_MTI) {
+    prvTickInterrupt(xCoreID);
+  }
+  else if (ulCause == portMCAUSE_MSI) {
+    // inter-core yield request
+    portMSIP(xCoreID) = 0;
+    vTaskSwitchContext(xCoreID);
+  }
+  else if ((ulCause & 0x80000000u) != 0) {
+    freertos_risc_v_application_interrupt_handler();
+  }
+  else {
+    freertos_risc_v_application_exception_handler();
+  }
+
+  uxPortInterruptNesting[xCoreID]--;
+}
+
+
+/******************************************************************************
+ * Kernel tick (hart portTICK_CORE only).
+ ******************************************************************************/
+static void prvTickInterrupt(BaseType_t xCoreID) {
+
+  UBaseType_t uxSavedInterruptStatus;
+  BaseType_t xSwitchRequired;
+  volatile uint32_t *pulCompare = portMTIMECMP(xCoreID);
+
+  // schedule the next tick
+  ullNextTime += uxTimerIncrementsForOneTick;
+  pulCompare[1] = 0xffffffffu; // prevent a spurious match while updating
+  pulCompare[0] = (uint32_t)ullNextTime;
+  pulCompare[1] = (uint32_t)(ullNextTime >> 32);
+
+  uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+  xSwitchRequired = xTaskIncrementTick();
+  taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+  if (xSwitchRequired != pdFALSE) {
+    vTaskSwitchContext(xCoreID);
+  }
+}
+
+
+/******************************************************************************
+ * Program the first tick (hart portTICK_CORE only).
+ ******************************************************************************/
+static void prvSetupTimerInterrupt(void) {
+
+  volatile uint32_t *pulCompare = portMTIMECMP(portTICK_CORE);
+  uint32_t ulHigh, ulLow;
+
+  uxTimerIncrementsForOneTick = (size_t)(ulPlatformClockHz / (configTICK_RATE_HZ));
+
+  do {
+    ulHigh = portMTIME[1];
+    ulLow = portMTIME[0];
+  } while (ulHigh != portMTIME[1]);
+
+  ullNextTime = (((uint64_t)ulHigh) << 32) | ulLow;
+  ullNextTime += uxTimerIncrementsForOneTick;
+  pulCompare[1] = 0xffffffffu;
+  pulCompare[0] = (uint32_t)ullNextTime;
+  pulCompare[1] = (uint32_t)(ullNextTime >> 32);
+}
+
+
+/******************************************************************************
+ * Entry point of hart 1: install the trap handler, enable inter-core
+ * yields and start the first task assigned to this hart.
+ ******************************************************************************/
+static int prvSecondaryCoreMain(void) {
+
+  neorv32_cpu_csr_write(CSR_MTVEC, (uint32_t)&freertos_risc_v_trap_handler);
+  portMSIP(1) = 0; // the launch request
+  neorv32_cpu_csr_set(CSR_MIE, 1u << CSR_MIE_MSIE);
+
+  xPortStartFirstTask();
+  return 0;
+}
+
+
+/******************************************************************************
+ * Start the scheduler on both harts (called by vTaskStartScheduler() on
+ * hart 0).
+ ******************************************************************************/
+BaseType_t xPortStartScheduler(void) {
+
+  BaseType_t xCoreID;
+
+  // interrupt stacks; filled so the stack monitor can determine their usage
+  memset(xISRStack, 0xee, sizeof(xISRStack));
+  for (xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
+    xPortIsrStackTops[xCoreID] = (StackType_t)&(xISRStack[xCoreID][configISR_STACK_SIZE_WORDS]);
+  }
+
+  // the idle tasks were created with the default (hart 0) affinity, but every hart needs one
+  for (xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++) {
+    vTaskCoreAffinitySet(xTaskGetIdleTaskHandleForCore(xCoreID), tskNO_AFFINITY);
+  }
+
+  // clear stale yield requests for this hart before hart 1 runs: from now on it may request a yield at any time
+  portMSIP(0) = 0;
+
+  // hart 1 starts its first task right away
+  if (neorv32_smp_launch(prvSecondaryCoreMain, ucSecondaryBootStack, sizeof(ucSecondaryBootStack)) != 0) {
+    configPRINT_STRING("ERROR! SMP: hart 1 did not start!\n");
+    return pdFAIL;
+  }
+
+  // kernel tick and inter-core yields for this hart
+  prvSetupTimerInterrupt();
+  neorv32_cpu_csr_set(CSR_MIE, (1u << CSR_MIE_MTIE) | (1u << CSR_MIE_MSIE));
+
+  xPortStartFirstTask();
+
+  // should not get here
+  return pdFAIL;
+}
+
+
+/******************************************************************************
+ * Stopping the scheduler is not supported.
+ ******************************************************************************/
+void vPortEndScheduler(void) {
+
+  configASSERT(0);
+}
+
+
+/******************************************************************************
+ * Request a context switch on a hart.
+ ******************************************************************************/
+void vPortYieldCore(BaseType_t xCoreID) {
+
+  portMEMORY_BARRIER(); // publish the scheduler state before the target hart looks at it
+  portMSIP(xCoreID) = 1;
+}
+
+
+#if defined(__riscv_atomic)
+/******************************************************************************
+ * Try to get the lock word (LR/SC). Returns non-zero on success.
+ ******************************************************************************/
+static inline uint32_t prvTryLock(PortRecursiveLock_t *pxLock, uint32_t ulCoreID) {
+
+  uint32_t ulFailed;
+
+  (void)ulCoreID;
+
+  __asm volatile (
+    "1: lr.w.aq %0, (%1)     \n"
+    "   bnez    %0, 2f       \n" // already taken
+    "   sc.w    %0, %2, (%1) \n"
+    "   bnez    %0, 1b       \n" // reservation lost: retry
+    "2:                      \n"
+    : "=&r" (ulFailed) : "r" (&pxLock->ulLock), "r" (1u) : "memory");
+
+  return (ulFailed == 0);
+}
+
+
+/******************************************************************************
+ * Release the lock word.
+ ******************************************************************************/
+static inline void prvUnlock(PortRecursiveLock_t *pxLock, uint32_t ulCoreID) {
+
+  (void)ulCoreID;
+
+  __asm volatile ("amoswap.w.rl zero, zero, (%0)" : : "r" (&pxLock->ulLock) : "memory");
+}
+
+#else
+/******************************************************************************
+ * Try to get the lock using Peterson's algorithm (two harts, no atomics).
+ * Returns non-zero on success.
+ ******************************************************************************/
+static inline uint32_t prvTryLock(PortRecursiveLock_t *pxLock, uint32_t ulCoreID) {
+
+  uint32_t ulOther = ulCoreID ^ 1u;
+
+  pxLock->ulFlag[ulCoreID] = 1;
+  pxLock->ulTurn = ulOther;
+  portMEMORY_BARRIER();
+  if ((pxLock->ulFlag[ulOther] != 0) && (pxLock->ulTurn == ulOther)) {
+    pxLock->ulFlag[ulCoreID] = 0;
+    return 0;
+  }
+  portMEMORY_BARRIER();
+  return 1;
+}
+
+
+/******************************************************************************
+ * Release the lock (Peterson's algorithm).
+ ******************************************************************************/
+static inline void prvUnlock(PortRecursiveLock_t *pxLock, uint32_t ulCoreID) {
+
+  portMEMORY_BARRIER();
+  pxLock->ulFlag[ulCoreID] = 0;
+}
+#endif
+
+
+/******************************************************************************
+ * Acquire a recursive kernel lock. Interrupts are masked while the owner is
+ * updated, so an interrupt handler on the same hart never sees a lock that
+ * is taken but not yet owned.
+ ******************************************************************************/
+void vPortRecursiveLockAcquire(PortRecursiveLock_t *pxLock) {
+
+  uint32_t ulCoreID = (uint32_t)portGET_CORE_ID();
+  UBaseType_t uxState;
+
+  for (;;) {
+    uxState = portSET_INTERRUPT_MASK();
+    if (pxLock->ulOwner == (ulCoreID + 1)) {
+      pxLock->ulCount++;
+      break;
+    }
+    if (prvTryLock(pxLock, ulCoreID) != 0) {
+      pxLock->ulOwner = ulCoreID + 1;
+      pxLock->ulCount = 1;
+      break;
+    }
+    portCLEAR_INTERRUPT_MASK(uxState);
+  }
+  portCLEAR_INTERRUPT_MASK(uxState);
+}
+
+
+/******************************************************************************
+ * Release a recursive kernel lock.
+ ******************************************************************************/
+void vPortRecursiveLockRelease(PortRecursiveLock_t *pxLock) {
+
+  uint32_t ulCoreID = (uint32_t)portGET_CORE_ID();
+  UBaseType_t uxState = portSET_INTERRUPT_MASK();
+
+  configASSERT(pxLock->ulOwner == (ulCoreID + 1));
+  if (--pxLock->ulCount == 0) {
+    pxLock->ulOwner = 0;
+    prvUnlock(pxLock, ulCoreID);
+  }
+  portCLEAR_INTERRUPT_MASK(uxState);
+}
@@ -0,0 +1,142 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * SMP port for the dual-core NEORV32 ("make SMP=1") - port macros
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * The generic FreeRTOS RISC-V port (portable/GCC/RISC-V) only supports a
+ * single core. This port replaces it for configNUMBER_OF_CORES = 2:
+ *
+ *  - both harts share one trap handler (portASM.S); each hart saves the
+ *    interrupted context to the stack of its own current task
+ *    (pxCurrentTCBs[mhartid]) and runs the handler on its own ISR stack
+ *  - the kernel tick uses hart 0's MTIMECMP; hart 1 is rescheduled by the
+ *    kernel (time slicing) via inter-core yields
+ *  - inter-core yield: CLINT machine software interrupt (MSIP) of the
+ *    target hart
+ *  - task and ISR locks: recursive spinlocks using LR/SC ('A' ISA
+ *    extension) or Peterson's algorithm if there are no atomics
+ *
+ * Hart 1 is started from xPortStartScheduler() via the NEORV32 HAL
+ * (neorv32_smp_launch()). The memory has to be coherent for both harts
+ * (no d-caches).
+ ******************************************************************************/
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include "irq_mask.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if __riscv_xlen != 32
+  #error "The NEORV32 SMP port only supports RV32!"
+#endif
+
+/* Type definitions */
+#define portSTACK_TYPE            uint32_t
+#define portBASE_TYPE             int32_t
+#define portUBASE_TYPE            uint32_t
+#define portMAX_DELAY             ( TickType_t ) 0xffffffffUL
+#define portPOINTER_SIZE_TYPE     uint32_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef portBASE_TYPE BaseType_t;
+typedef portUBASE_TYPE UBaseType_t;
+typedef portUBASE_TYPE TickType_t;
+
+/* 32-bit tick type on a 32-bit architecture, so reads of the tick count do not need to be guarded */
+#define portTICK_TYPE_IS_ATOMIC   1
+
+/* Architecture specifics */
+#define portSTACK_GROWTH          ( -1 )
+#define portTICK_PERIOD_MS        ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portBYTE_ALIGNMENT        16
+#define portNOP()                 __asm volatile ( "nop" )
+#define portINLINE                __inline
+#ifndef portFORCE_INLINE
+  #define portFORCE_INLINE        inline __attribute__( ( always_inline ) )
+#endif
+#define portMEMORY_BARRIER()      __asm volatile ( "fence" ::: "memory" )
+
+/* Task function macros as described on the FreeRTOS.org WEB site */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void * pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters )       void vFunction( void * pvParameters )
+
+/* Multi-core */
+#define portGET_CORE_ID()         xPortGetCoreID()
+#define portYIELD_CORE( xCoreID ) vPortYieldCore( xCoreID )
+#define portCHECK_IF_IN_ISR()     ( uxPortInterruptNesting[ portGET_CORE_ID() ] != 0 )
+
+/* Scheduler utilities */
+extern void vTaskSwitchContext( BaseType_t xCoreID );
+#define portYIELD()               __asm volatile ( "ecall" )
+#define portEND_SWITCHING_ISR( xSwitchRequired ) \
+  do { if( xSwitchRequired ) { vTaskSwitchContext( portGET_CORE_ID() ); } } while( 0 )
+#define portYIELD_FROM_ISR( x )   portEND_SWITCHING_ISR( x )
+
+/* Interrupt masking (mstatus.MIE of the calling hart) */
+#define portDISABLE_INTERRUPTS()                   __asm volatile ( "csrc mstatus, 8" ::: "memory" )
+#define portENABLE_INTERRUPTS()                    __asm volatile ( "csrs mstatus, 8" ::: "memory" )
+#define portSET_INTERRUPT_MASK()                   ( ( UBaseType_t ) ( ulIrqMaskSave() & 8u ) )
+#define portCLEAR_INTERRUPT_MASK( ulState )        vIrqMaskRestore( ( uint32_t ) ( ulState ) )
+#define portSET_INTERRUPT_MASK_FROM_ISR()          portSET_INTERRUPT_MASK()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( ulState ) portCLEAR_INTERRUPT_MASK( ulState )
+
+/* Critical sections (the nesting count is kept per hart) */
+extern void vTaskEnterCritical( void );
+extern void vTaskExitCritical( void );
+extern UBaseType_t vTaskEnterCriticalFromISR( void );
+extern void vTaskExitCriticalFromISR( UBaseType_t uxSavedInterruptStatus );
+#define portENTER_CRITICAL()                       vTaskEnterCritical()
+#define portEXIT_CRITICAL()                        vTaskExitCritical()
+#define portENTER_CRITICAL_FROM_ISR()              vTaskEnterCriticalFromISR()
+#define portEXIT_CRITICAL_FROM_ISR( x )            vTaskExitCriticalFromISR( x )
+
+#define portCRITICAL_NESTING_IN_TCB                0
+#define portGET_CRITICAL_NESTING_COUNT( xCoreID )        ( uxPortCriticalNesting[ ( xCoreID ) ] )
+#define portSET_CRITICAL_NESTING_COUNT( xCoreID, x )     ( uxPortCriticalNesting[ ( xCoreID ) ] = ( x ) )
+#define portINCREMENT_CRITICAL_NESTING_COUNT( xCoreID )  ( uxPortCriticalNesting[ ( xCoreID ) ]++ )
+#define portDECREMENT_CRITICAL_NESTING_COUNT( xCoreID )  ( uxPortCriticalNesting[ ( xCoreID ) ]-- )
+
+/* Kernel locks (recursive spinlocks) */
+typedef struct {
+  volatile uint32_t ulLock;     // LR/SC lock word
+  volatile uint32_t ulFlag[2];  // Peterson's algorithm (no atomics)
+  volatile uint32_t ulTurn;
+  volatile uint32_t ulOwner;    // hart ID + 1 of the owner; 0 = free
+  uint32_t ulCount;             // recursion depth
+} PortRecursiveLock_t;
+
+extern PortRecursiveLock_t xPortTaskLock;
+extern PortRecursiveLock_t xPortIsrLock;
+#define portGET_TASK_LOCK( xCoreID )               vPortRecursiveLockAcquire( &xPortTaskLock )
+#define portRELEASE_TASK_LOCK( xCoreID )           vPortRecursiveLockRelease( &xPortTaskLock )
+#define portGET_ISR_LOCK( xCoreID )                vPortRecursiveLockAcquire( &xPortIsrLock )
+#define portRELEASE_ISR_LOCK( xCoreID )            vPortRecursiveLockRelease( &xPortIsrLock )
+
+/* Port functions and state (port.c) */
+extern volatile UBaseType_t uxPortCriticalNesting[ configNUMBER_OF_CORES ];
+extern volatile UBaseType_t uxPortInterruptNesting[ configNUMBER_OF_CORES ];
+void vPortYieldCore( BaseType_t xCoreID );
+void vPortRecursiveLockAcquire( PortRecursiveLock_t * pxLock );
+void vPortRecursiveLockRelease( PortRecursiveLock_t * pxLock );
+
+static portFORCE_INLINE BaseType_t xPortGetCoreID( void )
+{
+  uint32_t ulHartId;
+  __asm volatile ( "csrr %0, mhartid" : "=r" ( ulHartId ) );
+  return ( BaseType_t ) ulHartId;
+}
+
+/* Task selection: generic C implementation (the optimized one is not supported for SMP) */
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+  #error "configUSE_PORT_OPTIMISED_TASK_SELECTION is not supported by the SMP port!"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
@@ -0,0 +1,251 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * SMP scaling benchmark
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Runs two workloads on smpbenchWORKERS worker tasks, first with all workers
+ * bound to hart 0 and then (SMP build, "make SMP=1") with the workers free to
+ * run on any hart:
+ *
+ *  - independent: every worker runs a compute-only loop (xorshift)
+ *  - pipeline:    worker 0 produces values that worker 1 consumes via a
+ *                 queue; both do some work per value, so the cost of the
+ *                 (cross-hart) wake-ups is part of the result
+ *
+ * The duration is measured in MTIME cycles (the same time base on both
+ * harts). Results are printed as one line per run, followed by the speedup
+ * (x100) of the SMP run:
+ *
+ *   #SMP:<test> harts=<n> cycles=<c>
+ *   #SMP:<test> speedup=<s>
+ *
+ * and "#SMP-END". A non-SMP build only runs the single-hart variant.
+ *
+ * Select this application using "make APP=smp_bench ...".
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Console */
+#include "console.h"
+
+/* Work per worker (xorshift rounds) and number of values passed through the pipeline */
+#ifndef configSMP_BENCH_ROUNDS
+  #define configSMP_BENCH_ROUNDS   ( 200000 )
+#endif
+#ifndef configSMP_BENCH_MESSAGES
+  #define configSMP_BENCH_MESSAGES ( 2000 )
+#endif
+
+/* Work per pipeline value (xorshift rounds) */
+#define smpbenchROUNDS_PER_MESSAGE ( 50 )
+
+/* Worker tasks; they only compute and use kernel objects, so they can run on any hart */
+#define smpbenchWORKERS            ( 2 )
+#define smpbenchWORKER_STACK_SIZE  ( configMINIMAL_STACK_SIZE / 2 )
+#define smpbenchWORKER_PRIORITY    ( tskIDLE_PRIORITY + 1 )
+#define smpbenchPRIORITY           ( tskIDLE_PRIORITY + 2 )
+
+/* Pipeline queue length */
+#define smpbenchQUEUE_LENGTH       ( 4 )
+
+/* Job of a worker (called with the worker's index) */
+typedef void (*SmpBenchJob_t)(uint32_t ulIndex);
+
+/* Prototypes */
+void smp_bench(void);
+static uint32_t prvXorShift(uint32_t ulState, uint32_t ulRounds);
+static void prvIndependentJob(uint32_t ulIndex);
+static void prvPipelineJob(uint32_t ulIndex);
+static void prvWorkerTask(void *pvParameters);
+static void prvSetAffinity(TaskHandle_t xTask, UBaseType_t uxHarts);
+static uint32_t prvRun(const char *pcName, SmpBenchJob_t pxJob, UBaseType_t uxHarts);
+static void prvBenchTask(void *pvParameters);
+
+/* Tasks and pipeline queue */
+static TaskHandle_t xBenchTask = NULL;
+static TaskHandle_t xWorkers[smpbenchWORKERS] = { NULL };
+static QueueHandle_t xPipeline = NULL;
+
+/* Current job and the workers' results (keeps the compiler from removing the work) */
+static volatile SmpBenchJob_t pxCurrentJob = NULL;
+static volatile uint32_t ulResults[smpbenchWORKERS];
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+static StaticTask_t xBenchTCB configSTATIC_DATA;
+static StackType_t xBenchStack[configMINIMAL_STACK_SIZE + 64] configSTATIC_DATA;
+static StaticTask_t xWorkerTCBs[smpbenchWORKERS] configSTATIC_DATA;
+static StackType_t xWorkerStacks[smpbenchWORKERS][smpbenchWORKER_STACK_SIZE] configSTATIC_DATA;
+static StaticQueue_t xPipelineBuffer configSTATIC_DATA;
+static uint8_t ucPipelineStorage[smpbenchQUEUE_LENGTH * sizeof(uint32_t)] configSTATIC_DATA;
+#endif
+
+
+/******************************************************************************
+ * Create the tasks and the pipeline queue and start the scheduler.
+ ******************************************************************************/
+void smp_bench(void) {
+
+  uint32_t i;
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  xPipeline = xQueueCreateStatic(smpbenchQUEUE_LENGTH, sizeof(uint32_t), ucPipelineStorage, &xPipelineBuffer);
+  xBenchTask = xTaskCreateStatic(prvBenchTask, "SmpBench", configMINIMAL_STACK_SIZE + 64, NULL, smpbenchPRIORITY,
+                                 xBenchStack, &xBenchTCB);
+  for (i = 0; i < smpbenchWORKERS; i++) {
+    xWorkers[i] = xTaskCreateStatic(prvWorkerTask, "Worker", smpbenchWORKER_STACK_SIZE, (void *)(uintptr_t)i,
+                                    smpbenchWORKER_PRIORITY, xWorkerStacks[i], &xWorkerTCBs[i]);
+  }
+#else
+  xPipeline = xQueueCreate(smpbenchQUEUE_LENGTH, sizeof(uint32_t));
+  xTaskCreate(prvBenchTask, "SmpBench", configMINIMAL_STACK_SIZE + 64, NULL, smpbenchPRIORITY, &xBenchTask);
+  for (i = 0; i < smpbenchWORKERS; i++) {
+    xTaskCreate(prvWorkerTask, "Worker", smpbenchWORKER_STACK_SIZE, (void *)(uintptr_t)i, smpbenchWORKER_PRIORITY, &xWorkers[i]);
+  }
+#endif
+
+  if ((xPipeline != NULL) && (xBenchTask != NULL) && (xWorkers[smpbenchWORKERS - 1] != NULL)) {
+    vTaskStartScheduler();
+  }
+
+  for (;;);
+}
+
+
+/******************************************************************************
+ * Compute-only work.
+ ******************************************************************************/
+static uint32_t prvXorShift(uint32_t ulState, uint32_t ulRounds) {
+
+  while (ulRounds--) {
+    ulState ^= ulState << 13;
+    ulState ^= ulState >> 17;
+    ulState ^= ulState << 5;
+  }
+  return ulState;
+}
+
+
+/******************************************************************************
+ * Jobs.
+ ******************************************************************************/
+static void prvIndependentJob(uint32_t ulIndex) {
+
+  ulResults[ulIndex] = prvXorShift(ulIndex + 1, configSMP_BENCH_ROUNDS);
+}
+
+static void prvPipelineJob(uint32_t ulIndex) {
+
+  uint32_t ulValue = ulIndex + 1, ulSum = 0, i;
+
+  for (i = 0; i < configSMP_BENCH_MESSAGES; i++) {
+    if (ulIndex == 0) { // producer
+      ulValue = prvXorShift(ulValue, smpbenchROUNDS_PER_MESSAGE);
+      xQueueSend(xPipeline, &ulValue, portMAX_DELAY);
+    }
+    else if (ulIndex == 1) { // consumer
+      xQueueReceive(xPipeline, &ulValue, portMAX_DELAY);
+      ulSum += prvXorShift(ulValue, smpbenchROUNDS_PER_MESSAGE);
+    }
+  }
+  ulResults[ulIndex] = ulSum + ulValue;
+}
+
+
+/******************************************************************************
+ * Worker: run the current job whenever the benchmark task says so.
+ ******************************************************************************/
+static void prvWorkerTask(void *pvParameters) {
+
+  uint32_t ulIndex = (uint32_t)(uintptr_t)pvParameters;
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    pxCurrentJob(ulIndex);
+    xTaskNotifyGive(xBenchTask);
+  }
+}
+
+
+/******************************************************************************
+ * Bind a (blocked) worker to hart 0 (uxHarts = 1) or allow all harts.
+ ******************************************************************************/
+static void prvSetAffinity(TaskHandle_t xTask, UBaseType_t uxHarts) {
+
+#if ( configNUMBER_OF_CORES > 1 )
+  vTaskCoreAffinitySet(xTask, (uxHarts == 1) ? (UBaseType_t)(1 << 0) : (UBaseType_t)tskNO_AFFINITY);
+#else
+  (void)xTask;
+  (void)uxHarts;
+#endif
+}
+
+
+/******************************************************************************
+ * Run a job on all workers using uxHarts harts; returns the duration in MTIME
+ * cycles.
+ ******************************************************************************/
+static uint32_t prvRun(const char *pcName, SmpBenchJob_t pxJob, UBaseType_t uxHarts) {
+
+  uint64_t ullStart;
+  uint32_t ulCycles, i;
+
+  pxCurrentJob = pxJob;
+  for (i = 0; i < smpbenchWORKERS; i++) {
+    prvSetAffinity(xWorkers[i], uxHarts);
+  }
+
+  ullStart = neorv32_clint_time_get();
+  for (i = 0; i < smpbenchWORKERS; i++) {
+    xTaskNotifyGive(xWorkers[i]);
+  }
+  for (i = 0; i < smpbenchWORKERS; i++) {
+    ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+  }
+  ulCycles = (uint32_t)(neorv32_clint_time_get() - ullStart);
+
+  vConsolePrintfBlocking("#SMP:%s harts=%u cycles=%u\n", pcName, (unsigned)uxHarts, (unsigned)ulCycles);
+  return ulCycles;
+}
+
+
+/******************************************************************************
+ * Benchmark task (hart 0).
+ ******************************************************************************/
+static void prvBenchTask(void *pvParameters) {
+
+  static const struct {
+    const char *pcName;
+    SmpBenchJob_t pxJob;
+  } xTests[] = {
+    { "independent", prvIndependentJob },
+    { "pipeline",    prvPipelineJob    }
+  };
+  uint32_t ulSingle, ulMulti, i;
+
+  (void)pvParameters;
+
+  vConsolePrintfBlocking("\nRunning SMP benchmark (%u harts, %u workers)...\n",
+                         (unsigned)configNUMBER_OF_CORES, (unsigned)smpbenchWORKERS);
+
+  for (i = 0; i < (sizeof(xTests) / sizeof(xTests[0])); i++) {
+    ulSingle = prvRun(xTests[i].pcName, xTests[i].pxJob, 1);
+    if (configNUMBER_OF_CORES > 1) {
+      ulMulti = prvRun(xTests[i].pcName, xTests[i].pxJob, configNUMBER_OF_CORES);
+      vConsolePrintfBlocking("#SMP:%s speedup=%u\n", xTests[i].pcName,
+                             (unsigned)(((uint64_t)ulSingle * 100) / ((ulMulti != 0) ? ulMulti : 1)));
+    }
+  }
+
+  vConsolePrintfBlocking("#SMP-END\n");
+  vTaskSuspend(NULL);
+}
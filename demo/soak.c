@@ -0,0 +1,488 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Synthetic workload generator / soak test
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Runs configSOAK_PAIRS producer/consumer pairs, each connected by its own
+ * queue:
+ *
+ *  - every producer is released by a periodic high-resolution timer
+ *    (configSOAK_PERIOD_US, hrtimer.c) and sends configSOAK_BURST messages
+ *    of configSOAK_MSG_BYTES bytes per period (without blocking; a full
+ *    queue counts as a drop)
+ *  - every consumer checks the sequence number and payload of each message,
+ *    computes for configSOAK_WORK_US and then holds a mutex shared by all
+ *    consumers for configSOAK_MUTEX_US (0 = no mutex)
+ *  - optionally a second high-resolution timer produces an interrupt storm:
+ *    one interrupt every configSOAK_STORM_PERIOD_US, each spending
+ *    configSOAK_STORM_WORK_US in the handler; the storm is switched on and
+ *    off every other report interval
+ *
+ * Latencies are measured in MTIME cycles from the release of a period. A
+ * deadline miss is a message whose response latency (release to message
+ * processed by the consumer) is above configSOAK_DEADLINE_US. The producer's
+ * wake-up latency is reported separately: a wake-up later than the deadline
+ * counts as "late" (its messages are usually missed as well, so it is not
+ * counted twice). Every configSOAK_REPORT_MS the reporter prints
+ *
+ *   #SOAK:t=<ms> storm=<irqs> msgs/s=<n> misses=<n> late=<n> drops=<n> errors=<n>
+ *   #SOAK-T:<task> msgs=<n> misses=<n> late=<n> max_lat_us=<n>   (one line per task)
+ *
+ * for that interval (storm = number of storm interrupts; max_lat_us is the
+ * wake-up latency for producers and the response latency for consumers).
+ * After configSOAK_DURATION_MS (0 = run forever) it stops the timers and
+ * prints the totals and "#SOAK-END":
+ *
+ *   #SOAK-SUM:msgs/s=<n> misses=<n> late=<n> drops=<n> errors=<n> max_lat_us=<n> max_wake_us=<n>
+ *
+ * All parameters can be set via USER_FLAGS; soak_sweep.sh runs a series of
+ * producer periods in simulation to find the breaking point of a
+ * configuration. Requires the GPTMR.
+ *
+ * Select this application using "make APP=soak ...".
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <semphr.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Console, high-resolution timers and detected clock */
+#include "console.h"
+#include "hrtimer.h"
+#include "platform.h"
+
+/* Workload */
+#ifndef configSOAK_PAIRS
+  #define configSOAK_PAIRS           ( 2 )
+#endif
+#ifndef configSOAK_MSG_BYTES
+  #define configSOAK_MSG_BYTES       ( 16 )
+#endif
+#ifndef configSOAK_PERIOD_US
+  #define configSOAK_PERIOD_US       ( 1000 )
+#endif
+#ifndef configSOAK_BURST
+  #define configSOAK_BURST           ( 1 )
+#endif
+#ifndef configSOAK_WORK_US
+  #define configSOAK_WORK_US         ( 0 )
+#endif
+#ifndef configSOAK_MUTEX_US
+  #define configSOAK_MUTEX_US        ( 20 )
+#endif
+#ifndef configSOAK_STORM_PERIOD_US
+  #define configSOAK_STORM_PERIOD_US ( 0 )
+#endif
+#ifndef configSOAK_STORM_WORK_US
+  #define configSOAK_STORM_WORK_US   ( 5 )
+#endif
+
+/* Deadline, report interval and duration */
+#ifndef configSOAK_DEADLINE_US
+  #define configSOAK_DEADLINE_US     ( configSOAK_PERIOD_US )
+#endif
+#ifndef configSOAK_REPORT_MS
+  #define configSOAK_REPORT_MS       ( 1000 )
+#endif
+#ifndef configSOAK_DURATION_MS
+  #define configSOAK_DURATION_MS     ( 0 )
+#endif
+
+#if ( configSOAK_PAIRS < 1 ) || ( configSOAK_PAIRS > 16 )
+  #error "configSOAK_PAIRS has to be in the range 1..16!"
+#endif
+#if ( configSOAK_MSG_BYTES < 8 ) || ( ( configSOAK_MSG_BYTES % 4 ) != 0 )
+  #error "configSOAK_MSG_BYTES has to be a multiple of 4 and at least 8!"
+#endif
+
+/* Message: release time (MTIME low word), sequence number, payload */
+#define soakMSG_WORDS          ( configSOAK_MSG_BYTES / 4 )
+
+/* Queue length (messages per pair) */
+#define soakQUEUE_LENGTH       ( 2 * configSOAK_BURST )
+
+/* Tasks */
+#define soakSTACK_SIZE         ( configMINIMAL_STACK_SIZE + soakMSG_WORDS )
+#define soakREPORT_STACK_SIZE  ( configMINIMAL_STACK_SIZE + 64 )
+#define soakCONSUMER_PRIORITY  ( tskIDLE_PRIORITY + 1 )
+#define soakPRODUCER_PRIORITY  ( tskIDLE_PRIORITY + 2 )
+#define soakREPORT_PRIORITY    ( tskIDLE_PRIORITY + 3 )
+
+/* Statistics of a task (interval counters are cleared by the reporter) */
+typedef struct {
+  uint32_t ulMessages;           // sent / processed
+  uint32_t ulMisses;             // response latency above the deadline (consumer)
+  uint32_t ulLate;               // wake-up latency above the deadline (producer)
+  uint32_t ulDrops;              // queue full (producer)
+  uint32_t ulErrors;             // bad sequence number or payload (consumer)
+  uint32_t ulMaxLatency;         // MTIME cycles; wake-up (producer) or response (consumer) latency
+} SoakStats_t;
+
+/* Producer/consumer pair */
+typedef struct {
+  QueueHandle_t xQueue;
+  HrTimer_t xTimer;              // releases the producer
+  SoakStats_t xStats[2];         // producer, consumer
+  char cName[2][configMAX_TASK_NAME_LEN];
+} SoakPair_t;
+
+/* Prototypes */
+void soak(void);
+static void prvSetName(char *pcName, const char *pcPrefix, uint32_t ulIndex);
+static void prvSpin(uint32_t ulUs);
+static void prvCount(SoakStats_t *pxStats, uint32_t ulLatency, BaseType_t xMiss);
+static void prvProducerTask(void *pvParameters);
+static void prvConsumerTask(void *pvParameters);
+static void prvStormCallback(void *pvContext);
+static void prvReportTask(void *pvParameters);
+
+/* Pairs, shared mutex and interrupt storm */
+static SoakPair_t xPairs[configSOAK_PAIRS];
+static SemaphoreHandle_t xSoakMutex = NULL;
+static HrTimer_t xStorm;
+static volatile uint32_t ulStormIrqs = 0;
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+static StaticTask_t xReportTCB configSTATIC_DATA;
+static StackType_t xReportStack[soakREPORT_STACK_SIZE] configSTATIC_DATA;
+static StaticTask_t xPairTCBs[configSOAK_PAIRS][2] configSTATIC_DATA;
+static StackType_t xPairStacks[configSOAK_PAIRS][2][soakSTACK_SIZE] configSTATIC_DATA;
+static StaticQueue_t xQueueBuffers[configSOAK_PAIRS] configSTATIC_DATA;
+static uint8_t ucQueueStorage[configSOAK_PAIRS][soakQUEUE_LENGTH * configSOAK_MSG_BYTES] configSTATIC_DATA;
+static StaticSemaphore_t xMutexBuffer configSTATIC_DATA;
+#endif
+
+
+/******************************************************************************
+ * Create the queues, the mutex and the tasks and start the scheduler.
+ ******************************************************************************/
+void soak(void) {
+
+  TaskHandle_t xTask = NULL;
+  uint32_t i;
+
+  if (neorv32_gptmr_available() == 0) {
+    vConsolePuts("ERROR! The soak test requires the GPTMR!\n");
+    return;
+  }
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  xSoakMutex = xSemaphoreCreateMutexStatic(&xMutexBuffer);
+  xTask = xTaskCreateStatic(prvReportTask, "Report", soakREPORT_STACK_SIZE, NULL, soakREPORT_PRIORITY,
+                            xReportStack, &xReportTCB);
+#else
+  xSoakMutex = xSemaphoreCreateMutex();
+  xTaskCreate(prvReportTask, "Report", soakREPORT_STACK_SIZE, NULL, soakREPORT_PRIORITY, &xTask);
+#endif
+  if ((xSoakMutex == NULL) || (xTask == NULL)) {
+    vConsolePuts("ERROR! Out of memory!\n");
+    return;
+  }
+
+  for (i = 0; i < configSOAK_PAIRS; i++) {
+    prvSetName(xPairs[i].cName[0], "Prod", i);
+    prvSetName(xPairs[i].cName[1], "Cons", i);
+    xTask = NULL;
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    xPairs[i].xQueue = xQueueCreateStatic(soakQUEUE_LENGTH, configSOAK_MSG_BYTES, ucQueueStorage[i], &xQueueBuffers[i]);
+    xTaskCreateStatic(prvConsumerTask, xPairs[i].cName[1], soakSTACK_SIZE, &xPairs[i], soakCONSUMER_PRIORITY,
+                      xPairStacks[i][1], &xPairTCBs[i][1]);
+    xTask = xTaskCreateStatic(prvProducerTask, xPairs[i].cName[0], soakSTACK_SIZE, &xPairs[i], soakPRODUCER_PRIORITY,
+                              xPairStacks[i][0], &xPairTCBs[i][0]);
+#else
+    xPairs[i].xQueue = xQueueCreate(soakQUEUE_LENGTH, configSOAK_MSG_BYTES);
+    if (xTaskCreate(prvConsumerTask, xPairs[i].cName[1], soakSTACK_SIZE, &xPairs[i], soakCONSUMER_PRIORITY, NULL) == pdPASS) {
+      xTaskCreate(prvProducerTask, xPairs[i].cName[0], soakSTACK_SIZE, &xPairs[i], soakPRODUCER_PRIORITY, &xTask);
+    }
+#endif
+    if ((xPairs[i].xQueue == NULL) || (xTask == NULL)) {
+      vConsolePuts("ERROR! Out of memory!\n");
+      return;
+    }
+  }
+
+  vHrTimerInit(&xStorm, prvStormCallback, NULL);
+  vTaskStartScheduler();
+
+  for (;;);
+}
+
+
+/******************************************************************************
+ * Task name: prefix and index.
+ ******************************************************************************/
+static void prvSetName(char *pcName, const char *pcPrefix, uint32_t ulIndex) {
+
+  while (*pcPrefix) {
+    *pcName++ = *pcPrefix++;
+  }
+  if (ulIndex >= 10) {
+    *pcName++ = '0' + (ulIndex / 10);
+  }
+  *pcName++ = '0' + (ulIndex % 10);
+  *pcName = '\0';
+}
+
+
+/******************************************************************************
+ * Busy-wait for ulUs microseconds (MTIME).
+ ******************************************************************************/
+static void prvSpin(uint32_t ulUs) {
+
+  uint64_t ullEnd = neorv32_clint_time_get() + hrtimerUS_TO_CYCLES(ulUs);
+
+  while (neorv32_clint_time_get() < ullEnd);
+}
+
+
+/******************************************************************************
+ * Count a processed message and its response latency (consumer).
+ ******************************************************************************/
+static void prvCount(SoakStats_t *pxStats, uint32_t ulLatency, BaseType_t xMiss) {
+
+  taskENTER_CRITICAL();
+  pxStats->ulMessages++;
+  if (xMiss != pdFALSE) {
+    pxStats->ulMisses++;
+  }
+  if (ulLatency > pxStats->ulMaxLatency) {
+    pxStats->ulMaxLatency = ulLatency;
+  }
+  taskEXIT_CRITICAL();
+}
+
+
+/******************************************************************************
+ * Producer: send a burst of messages every period.
+ ******************************************************************************/
+static void prvProducerTask(void *pvParameters) {
+
+  SoakPair_t *pxPair = (SoakPair_t *)pvParameters;
+  SoakStats_t *pxStats = &pxPair->xStats[0];
+  uint32_t ulMessage[soakMSG_WORDS];
+  uint32_t ulDeadline = (uint32_t)hrtimerUS_TO_CYCLES(configSOAK_DEADLINE_US);
+  uint64_t ullRelease, ullNow;
+  uint32_t ulSeq = 0, ulSent, ulLatency, i, j;
+
+  vHrTimerInitDeferred(&pxPair->xTimer, xTaskGetCurrentTaskHandle(), 1);
+  taskENTER_CRITICAL();
+  xHrTimerStart(&pxPair->xTimer, configSOAK_PERIOD_US, configSOAK_PERIOD_US);
+  taskEXIT_CRITICAL();
+
+  for (;;) {
+    ulHrTimerWait(portMAX_DELAY);
+
+    // release = the deadline that has actually fired (the timer skips periods that have been missed entirely)
+    taskENTER_CRITICAL();
+    ullNow = neorv32_clint_time_get();
+    ullRelease = pxPair->xTimer.ullExpired;
+    taskEXIT_CRITICAL();
+    ulLatency = (uint32_t)(ullNow - ullRelease);
+
+    ulSent = 0;
+    for (i = 0; i < configSOAK_BURST; i++) {
+      ulMessage[0] = (uint32_t)ullRelease;
+      ulMessage[1] = ulSeq;
+      for (j = 2; j < soakMSG_WORDS; j++) {
+        ulMessage[j] = ulSeq + j;
+      }
+      if (xQueueSend(pxPair->xQueue, ulMessage, 0) == pdPASS) {
+        ulSeq++;
+        ulSent++;
+      }
+    }
+
+    // a late wake-up is not a miss by itself: the consumer counts the misses of these messages
+    taskENTER_CRITICAL();
+    pxStats->ulMessages += ulSent;
+    pxStats->ulDrops += configSOAK_BURST - ulSent;
+    if (ulLatency > ulDeadline) {
+      pxStats->ulLate++;
+    }
+    if (ulLatency > pxStats->ulMaxLatency) {
+      pxStats->ulMaxLatency = ulLatency;
+    }
+    taskEXIT_CRITICAL();
+  }
+}
+
+
+/******************************************************************************
+ * Consumer: check, process and account every message.
+ ******************************************************************************/
+static void prvConsumerTask(void *pvParameters) {
+
+  SoakPair_t *pxPair = (SoakPair_t *)pvParameters;
+  SoakStats_t *pxStats = &pxPair->xStats[1];
+  uint32_t ulMessage[soakMSG_WORDS];
+  uint32_t ulDeadline = (uint32_t)hrtimerUS_TO_CYCLES(configSOAK_DEADLINE_US);
+  uint32_t ulExpected = 0, ulLatency, j;
+
+  for (;;) {
+    xQueueReceive(pxPair->xQueue, ulMessage, portMAX_DELAY);
+
+    // the producer only advances the sequence number for messages that have been sent
+    for (j = 2; j < soakMSG_WORDS; j++) {
+      if (ulMessage[j] != ulMessage[1] + j) {
+        break;
+      }
+    }
+    if ((ulMessage[1] != ulExpected) || (j != soakMSG_WORDS)) {
+      taskENTER_CRITICAL();
+      pxStats->ulErrors++;
+      taskEXIT_CRITICAL();
+    }
+    ulExpected = ulMessage[1] + 1;
+
+    if (configSOAK_WORK_US > 0) {
+      prvSpin(configSOAK_WORK_US);
+    }
+    if (configSOAK_MUTEX_US > 0) {
+      xSemaphoreTake(xSoakMutex, portMAX_DELAY);
+      prvSpin(configSOAK_MUTEX_US);
+      xSemaphoreGive(xSoakMutex);
+    }
+
+    ulLatency = (uint32_t)neorv32_clint_time_get() - ulMessage[0];
+    prvCount(pxStats, ulLatency, (ulLatency > ulDeadline) ? pdTRUE : pdFALSE);
+  }
+}
+
+
+/******************************************************************************
+ * Interrupt storm: burn time in interrupt context.
+ ******************************************************************************/
+configFAST_TEXT static void prvStormCallback(void *pvContext) {
+
+  (void)pvContext;
+
+  ulStormIrqs++;
+  prvSpin(configSOAK_STORM_WORK_US);
+}
+
+
+/******************************************************************************
+ * Reporter: print (and clear) the statistics every configSOAK_REPORT_MS.
+ ******************************************************************************/
+static void prvReportTask(void *pvParameters) {
+
+  static SoakStats_t xSnapshot[configSOAK_PAIRS][2];
+  static SoakStats_t xTotal;
+  static uint32_t ulTotalMaxWake = 0;
+  TickType_t xLastWake = xTaskGetTickCount();
+  SoakStats_t xInterval;
+  BaseType_t xStormOn = pdFALSE;
+  uint32_t ulElapsed = 0, ulStorm, ulMaxWake, i, k;
+
+  (void)pvParameters;
+
+  vConsolePrintfBlocking("\nRunning soak test...\n");
+  vConsolePrintfBlocking("#SOAK-CFG:pairs=%u bytes=%u period_us=%u burst=%u work_us=%u mutex_us=%u "
+                         "storm_period_us=%u storm_work_us=%u deadline_us=%u\n",
+                         (unsigned)configSOAK_PAIRS, (unsigned)configSOAK_MSG_BYTES, (unsigned)configSOAK_PERIOD_US,
+                         (unsigned)configSOAK_BURST, (unsigned)configSOAK_WORK_US, (unsigned)configSOAK_MUTEX_US,
+                         (unsigned)configSOAK_STORM_PERIOD_US, (unsigned)configSOAK_STORM_WORK_US,
+                         (unsigned)configSOAK_DEADLINE_US);
+
+  for (;;) {
+    vTaskDelayUntil(&xLastWake, pdMS_TO_TICKS(configSOAK_REPORT_MS));
+    ulElapsed += configSOAK_REPORT_MS;
+
+    // take a consistent snapshot and clear the interval counters
+    taskENTER_CRITICAL();
+    for (i = 0; i < configSOAK_PAIRS; i++) {
+      for (k = 0; k < 2; k++) {
+        xSnapshot[i][k] = xPairs[i].xStats[k];
+        xPairs[i].xStats[k] = (SoakStats_t){ 0 };
+      }
+    }
+    ulStorm = ulStormIrqs;
+    ulStormIrqs = 0;
+    taskEXIT_CRITICAL();
+
+    // producer (k = 0) latencies are wake-up latencies, consumer (k = 1) latencies are response latencies
+    xInterval = (SoakStats_t){ 0 };
+    ulMaxWake = 0;
+    for (i = 0; i < configSOAK_PAIRS; i++) {
+      for (k = 0; k < 2; k++) {
+        if (k == 0) {
+          if (xSnapshot[i][k].ulMaxLatency > ulMaxWake) {
+            ulMaxWake = xSnapshot[i][k].ulMaxLatency;
+          }
+        }
+        else {
+          xInterval.ulMessages += xSnapshot[i][k].ulMessages; // throughput = processed messages
+          if (xSnapshot[i][k].ulMaxLatency > xInterval.ulMaxLatency) {
+            xInterval.ulMaxLatency = xSnapshot[i][k].ulMaxLatency;
+          }
+        }
+        xInterval.ulMisses += xSnapshot[i][k].ulMisses;
+        xInterval.ulLate += xSnapshot[i][k].ulLate;
+        xInterval.ulDrops += xSnapshot[i][k].ulDrops;
+        xInterval.ulErrors += xSnapshot[i][k].ulErrors;
+      }
+    }
+    xTotal.ulMessages += xInterval.ulMessages;
+    xTotal.ulMisses += xInterval.ulMisses;
+    xTotal.ulLate += xInterval.ulLate;
+    xTotal.ulDrops += xInterval.ulDrops;
+    xTotal.ulErrors += xInterval.ulErrors;
+    if (xInterval.ulMaxLatency > xTotal.ulMaxLatency) {
+      xTotal.ulMaxLatency = xInterval.ulMaxLatency;
+    }
+    if (ulMaxWake > ulTotalMaxWake) {
+      ulTotalMaxWake = ulMaxWake;
+    }
+
+    vConsolePrintfBlocking("#SOAK:t=%u storm=%u msgs/s=%u misses=%u late=%u drops=%u errors=%u\n", (unsigned)ulElapsed,
+                           (unsigned)ulStorm, (unsigned)(((uint64_t)xInterval.ulMessages * 1000) / configSOAK_REPORT_MS),
+                           (unsigned)xInterval.ulMisses, (unsigned)xInterval.ulLate, (unsigned)xInterval.ulDrops,
+                           (unsigned)xInterval.ulErrors);
+    for (i = 0; i < configSOAK_PAIRS; i++) {
+      for (k = 0; k < 2; k++) {
+        vConsolePrintfBlocking("#SOAK-T:%s msgs=%u misses=%u late=%u max_lat_us=%u\n", xPairs[i].cName[k],
+                               (unsigned)xSnapshot[i][k].ulMessages, (unsigned)xSnapshot[i][k].ulMisses,
+                               (unsigned)xSnapshot[i][k].ulLate,
+                               (unsigned)ulPlatformDivU32(xSnapshot[i][k].ulMaxLatency, ulPlatformCyclesPerUs));
+      }
+    }
+
+#if ( configSOAK_DURATION_MS > 0 )
+    if (ulElapsed >= configSOAK_DURATION_MS) {
+      break;
+    }
+#endif
+
+    // toggle the interrupt storm for the next interval
+    if (configSOAK_STORM_PERIOD_US > 0) {
+      xStormOn = (xStormOn == pdFALSE) ? pdTRUE : pdFALSE;
+      if (xStormOn != pdFALSE) {
+        xHrTimerStart(&xStorm, configSOAK_STORM_PERIOD_US, configSOAK_STORM_PERIOD_US);
+      }
+      else {
+        vHrTimerStop(&xStorm);
+      }
+    }
+  }
+
+  vHrTimerStop(&xStorm);
+  for (i = 0; i < configSOAK_PAIRS; i++) {
+    vHrTimerStop(&xPairs[i].xTimer);
+  }
+
+  vConsolePrintfBlocking("#SOAK-SUM:msgs/s=%u misses=%u late=%u drops=%u errors=%u max_lat_us=%u max_wake_us=%u\n",
+                         (unsigned)(((uint64_t)xTotal.ulMessages * 1000) / ulElapsed), (unsigned)xTotal.ulMisses,
+                         (unsigned)xTotal.ulLate, (unsigned)xTotal.ulDrops, (unsigned)xTotal.ulErrors,
+                         (unsigned)ulPlatformDivU32(xTotal.ulMaxLatency, ulPlatformCyclesPerUs),
+                         (unsigned)ulPlatformDivU32(ulTotalMaxWake, ulPlatformCyclesPerUs));
+  vConsolePrintfBlocking("#SOAK-END\n");
+  vTaskSuspend(NULL);
+}
@@ -0,0 +1,42 @@
+#!/usr/bin/env bash
+
+# Run the soak test (soak.c) in simulation for a series of producer periods
+# and report throughput, deadline misses, late producer wake-ups and the maximum
+# response / wake-up latency of each run.
+# The first period with misses or drops is the breaking point of the
+# configuration. Additional soak parameters can be passed via SOAK_FLAGS.
+#   PERIODS="1000 500 200 100" SOAK_FLAGS="-DconfigSOAK_PAIRS=4" soak_sweep.sh [profile]
+
+set -e
+
+cd $(dirname "$0")
+
+PROFILE=${1:-default}
+PERIODS=${PERIODS:-"1000 500 200 100 50"}
+SOAK_FLAGS=${SOAK_FLAGS:-""}
+REPORT=""
+
+for us in $PERIODS; do
+  make USER_FLAGS+="-DUART0_SIM_MODE -DconfigSOAK_PERIOD_US=$us -DconfigSOAK_REPORT_MS=10 -DconfigSOAK_DURATION_MS=40 $SOAK_FLAGS" \
+       APP=soak PROFILE=$PROFILE clean_all exe install
+  rm -f ../neorv32/sim/ghdl.log # a failed run must not report the results of the previous one
+  make -i GHDL_RUN_FLAGS="--stop-time=60ms" sim
+
+  # totals of the run
+  sum=$(grep -a '#SOAK-SUM:' ../neorv32/sim/ghdl.log | tail -n 1)
+  rate=$(echo "$sum" | sed -n 's/.*msgs\/s=\([0-9]*\).*/\1/p')
+  misses=$(echo "$sum" | sed -n 's/.*misses=\([0-9]*\).*/\1/p')
+  late=$(echo "$sum" | sed -n 's/.*late=\([0-9]*\).*/\1/p')
+  drops=$(echo "$sum" | sed -n 's/.*drops=\([0-9]*\).*/\1/p')
+  errors=$(echo "$sum" | sed -n 's/.*errors=\([0-9]*\).*/\1/p')
+  latency=$(echo "$sum" | sed -n 's/.*max_lat_us=\([0-9]*\).*/\1/p')
+  wake=$(echo "$sum" | sed -n 's/.*max_wake_us=\([0-9]*\).*/\1/p')
+
+  REPORT+=$(printf "%10s %10s %8s %8s %8s %8s %12s %12s" "$us" "${rate:--}" "${misses:--}" "${late:--}" "${drops:--}" \
+                   "${errors:--}" "${latency:--}" "${wake:--}")$'\n'
+done
+
+echo ""
+printf "%10s %10s %8s %8s %8s %8s %12s %12s\n" "period_us" "msgs/s" "misses" "late" "drops" "errors" "max_lat_us" \
+       "max_wake_us"
+printf "%s" "$REPORT"
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * PMP-based hardware stack guard
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Stack guard and console */
+#include "stack_guard.h"
+#include "console.h"
+
+#if ( configUSE_PMP_STACK_GUARD == 1 )
+
+#if ((configPMP_STACK_GUARD_SIZE & portBYTE_ALIGNMENT_MASK) != 0)
+  #error "configPMP_STACK_GUARD_SIZE has to be a multiple of portBYTE_ALIGNMENT!"
+#endif
+
+#if ( configCHECK_FOR_STACK_OVERFLOW == 0 )
+  #warning "PMP stack guard without configCHECK_FOR_STACK_OVERFLOW: overflows by the trap entry are not detected!"
+#endif
+
+/* PMP configuration bytes */
+#define stackguardPMP_R     ( 1 << 0 )
+#define stackguardPMP_W     ( 1 << 1 )
+#define stackguardPMP_X     ( 1 << 2 )
+#define stackguardPMP_TOR   ( 1 << 3 )
+#define stackguardPMP_NAPOT ( 3 << 3 )
+
+/* mstatus.MPP (machine mode = 11) */
+#define stackguardMPP       ( 3u << CSR_MSTATUS_MPP_L )
+
+/* Byte offset of mstatus in the port's task frame (portContext.h: portMSTATUS_OFFSET, stack_guard_frame.S) */
+extern const uint8_t __stack_guard_frame_mstatus[];
+#define stackguardFRAME_MSTATUS ( (uint32_t)__stack_guard_frame_mstatus )
+
+
+/******************************************************************************
+ * Setup the PMP regions and enable checking of task loads/stores. Has to be
+ * called before any task is created, as new tasks inherit mstatus.MPRV.
+ ******************************************************************************/
+void vStackGuardInit(void) {
+
+  uint32_t ulConfig;
+
+  if (((neorv32_cpu_csr_read(CSR_MISA) & (1 << CSR_MISA_U)) == 0) ||
+      (neorv32_cpu_pmp_get_num_regions() < 3) ||
+      (neorv32_cpu_pmp_get_granularity() > configPMP_STACK_GUARD_SIZE)) {
+    vConsolePanicPuts("ERROR! PMP stack guard requires U-mode and >= 3 PMP regions!\n");
+    configASSERT(0);
+  }
+
+  // entry 0: off (lower bound of the guard); entry 1: guard (no access); entry 2: all (RWX)
+  ulConfig = ((uint32_t)stackguardPMP_TOR << 8) |
+             ((uint32_t)(stackguardPMP_NAPOT | stackguardPMP_R | stackguardPMP_W | stackguardPMP_X) << 16);
+
+  neorv32_cpu_csr_write(CSR_PMPADDR0, 0);
+  neorv32_cpu_csr_write(CSR_PMPADDR1, 0); // empty guard until the first task is switched in
+  neorv32_cpu_csr_write(CSR_PMPADDR2, 0xffffffffu);
+  neorv32_cpu_csr_write(CSR_PMPCFG0, ulConfig);
+
+  // keep main() unchecked (MPP = M); tasks get MPP = U on their first mret
+  neorv32_cpu_csr_set(CSR_MSTATUS, (1 << CSR_MSTATUS_MPP_H) | (1 << CSR_MSTATUS_MPP_L));
+  neorv32_cpu_csr_set(CSR_MSTATUS, 1 << CSR_MSTATUS_MPRV);
+}
+
+
+/******************************************************************************
+ * Let the first task start with MPP = U (called by vTaskStartScheduler() with
+ * the first task's initial stack frame). All later tasks are resumed via mret,
+ * which sets MPP = U by itself. The frame is only used by the port's first
+ * task start, which jumps to the task (no mret), so the task keeps running in
+ * machine mode.
+ ******************************************************************************/
+void vStackGuardStartFirstTask(void *pvTopOfStack) {
+
+  uint32_t *pulStatus = (uint32_t *)((uint8_t *)pvTopOfStack + stackguardFRAME_MSTATUS);
+
+  configASSERT((*pulStatus & stackguardMPP) == stackguardMPP); // initial mstatus (MPP = M) of the frame
+  *pulStatus &= ~stackguardMPP;
+}
+
+
+/******************************************************************************
+ * Check if an exception is an access to the guard of the running task (to be
+ * called from the exception handler). Does not return in that case.
+ ******************************************************************************/
+void vStackGuardCheckFault(uint32_t ulCause, uint32_t ulAddress) {
+
+  uint32_t ulGuard = neorv32_cpu_csr_read(CSR_PMPADDR0) << 2;
+
+  if (((ulCause == TRAP_CODE_L_ACCESS) || (ulCause == TRAP_CODE_S_ACCESS)) &&
+      ((ulAddress - ulGuard) < configPMP_STACK_GUARD_SIZE)) {
+
+    taskDISABLE_INTERRUPTS();
+
+    vConsolePanicPuts("FreeRTOS_FAULT: stack overflow (PMP stack guard) in task ");
+    vConsolePanicPuts(pcTaskGetName(NULL));
+    vConsolePanicPuts(" (increase its stack size, see tools/stack_report.py)\n");
+
+    while(1);
+  }
+}
+
+#endif /* configUSE_PMP_STACK_GUARD */
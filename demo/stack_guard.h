@@ -0,0 +1,99 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * PMP-based hardware stack guard
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Complements the kernel's software stack overflow check (pattern compare on
+ * every context switch, configCHECK_FOR_STACK_OVERFLOW = 2) by a no-access
+ * PMP region covering the lowest configPMP_STACK_GUARD_SIZE bytes of the
+ * running task's stack. The first load or store of a task into this area
+ * traps with a precise load/store access fault.
+ *
+ * Tasks run in machine mode, where unlocked PMP regions do not apply. Hence,
+ * mstatus.MPRV is set so all loads and stores are checked with the privilege
+ * of mstatus.MPP. The CPU sets MPP to user mode on every mret (i.e. when a
+ * task is resumed) and to machine mode on every trap, so tasks are checked
+ * while the trap handler and the kernel's context switch are not. MPRV is
+ * part of the saved mstatus, so no additional context is required. The port
+ * starts the first task with a plain jump (no mret) using the mstatus of its
+ * initial stack frame, so vStackGuardStartFirstTask() sets MPP = U in that
+ * frame (traceSTARTING_SCHEDULER) and the first task is checked from its
+ * first instruction as well.
+ *
+ *   PMP entry 0: OFF, address = guard base (lower bound of entry 1)
+ *   PMP entry 1: TOR, no access: guard [stack base, stack base + guard size)
+ *   PMP entry 2: NAPOT, RWX: everything else
+ *
+ * Only the guard address (pmpaddr0/1) is updated on a context switch.
+ * Requirements: U-mode, >= 3 PMP regions, TOR and NAPOT modes, PMP
+ * granularity <= configPMP_STACK_GUARD_SIZE.
+ *
+ * Gaps: the trap entry pushes the task's context frame with MPP = M, so this
+ * push is not checked. A stack frame that is larger than the guard may skip
+ * it entirely. The default guard (256 bytes) covers the context frame (128
+ * bytes) plus a 128-byte function frame; the software check (method 1 or 2)
+ * stays enabled to detect frames that were pushed beyond the guard.
+ *
+ * This file is included by FreeRTOSConfig.h so the switch hook is visible to
+ * the kernel sources. It must not depend on any FreeRTOS types.
+ ******************************************************************************/
+
+#ifndef STACK_GUARD_H
+#define STACK_GUARD_H
+
+#include <stdint.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+#if ( configUSE_PMP_STACK_GUARD == 1 )
+
+void vStackGuardInit(void);
+void vStackGuardStartFirstTask(void *pvTopOfStack);
+void vStackGuardCheckFault(uint32_t ulCause, uint32_t ulAddress);
+
+
+/******************************************************************************
+ * Move the guard to the stack of the task that is switched in.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vStackGuardSwitch(const void *pvStackBase) {
+
+  uint32_t ulBase = (uint32_t)pvStackBase;
+
+  __asm volatile ("csrw pmpaddr0, %0" : : "r" (ulBase >> 2));
+  __asm volatile ("csrw pmpaddr1, %0" : : "r" ((ulBase + configPMP_STACK_GUARD_SIZE) >> 2));
+}
+
+
+/******************************************************************************
+ * Temporarily disable / re-enable the guard for the calling task (e.g. for
+ * uxTaskGetSystemState(), which scans the caller's own guard area for the
+ * high-water mark).
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint32_t ulStackGuardSuspend(void) {
+
+  uint32_t ulStatus;
+  __asm volatile ("csrrc %0, mstatus, %1" : "=r" (ulStatus) : "r" (1 << CSR_MSTATUS_MPRV) : "memory");
+  return ulStatus;
+}
+
+static inline __attribute__((always_inline)) void vStackGuardResume(uint32_t ulStatus) {
+
+  __asm volatile ("csrs mstatus, %0" : : "r" (ulStatus & (1 << CSR_MSTATUS_MPRV)) : "memory");
+}
+
+/* Kernel hooks; pxCurrentTCB is only valid within tasks.c */
+#define stackguardTASK_SWITCHED_IN()         vStackGuardSwitch(pxCurrentTCB->pxStack)
+#define traceSTARTING_SCHEDULER(xIdleTasks)  vStackGuardStartFirstTask(pxCurrentTCB->pxTopOfStack)
+
+#else
+
+#define vStackGuardInit()
+#define vStackGuardCheckFault(ulCause, ulAddress)
+#define ulStackGuardSuspend()                ( 0 )
+#define vStackGuardResume(ulStatus)          ( void )( ulStatus )
+#define stackguardTASK_SWITCHED_IN()
+
+#endif /* configUSE_PMP_STACK_GUARD */
+
+#endif /* STACK_GUARD_H */
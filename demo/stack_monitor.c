@@ -0,0 +1,134 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Stack high-water-mark monitor
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Stack monitor and console */
+#include "stack_monitor.h"
+#include "stack_guard.h"
+#include "console.h"
+
+#if ( configRECORD_STACK_HIGH_ADDRESS != 1 )
+  #error "The stack monitor requires configRECORD_STACK_HIGH_ADDRESS = 1!"
+#endif
+
+/* Fill pattern of the ISR stack (see portISR_STACK_FILL_BYTE in the RISC-V port) */
+#define stackISR_FILL_WORD ( 0xeeeeeeeeu )
+
+/* Top of the ISR stack (FreeRTOS RISC-V port) */
+extern const StackType_t xISRStackTop;
+
+/* Task states of the last report (static to keep the monitor's own stack small) */
+static TaskStatus_t xTaskStatus[configSTACK_MONITOR_MAX_TASKS];
+
+/* Prototypes */
+#if ( configUSE_STACK_MONITOR == 1 )
+static void prvStackMonitorTask(void *pvParameters);
+#endif
+
+
+/******************************************************************************
+ * Get the size of the ISR stack in words.
+ ******************************************************************************/
+uint32_t ulStackMonitorIsrSize(void) {
+
+  return (uint32_t)(configISR_STACK_SIZE_WORDS & ~portBYTE_ALIGNMENT_MASK);
+}
+
+
+/******************************************************************************
+ * Get the peak usage of the ISR stack in words. The port only paints the ISR
+ * stack if configASSERT is defined; returns 0 otherwise.
+ ******************************************************************************/
+uint32_t ulStackMonitorIsrPeak(void) {
+
+#if ( configASSERT_DEFINED == 1 )
+  const uint32_t *pulWord = (const uint32_t *)xISRStackTop - ulStackMonitorIsrSize();
+  uint32_t ulFree = 0;
+
+  // the stack grows downwards: count the untouched words from the bottom
+  while ((ulFree < ulStackMonitorIsrSize()) && (pulWord[ulFree] == stackISR_FILL_WORD)) {
+    ulFree++;
+  }
+  return ulStackMonitorIsrSize() - ulFree;
+#else
+  return 0;
+#endif
+}
+
+
+/******************************************************************************
+ * Print size and peak usage (in words) of all task stacks and of the ISR
+ * stack. Must be called from a task.
+ ******************************************************************************/
+void vStackMonitorReport(void) {
+
+  UBaseType_t uxTasks, i;
+  uint32_t ulSize, ulGuard;
+
+  ulGuard = ulStackGuardSuspend(); // the high-water mark scan reads the caller's guard area
+  uxTasks = uxTaskGetSystemState(xTaskStatus, configSTACK_MONITOR_MAX_TASKS, NULL);
+  vStackGuardResume(ulGuard);
+
+  vConsolePrintfBlocking("\n--- Stack high-water marks (words) ---\n");
+
+  for (i = 0; i < uxTasks; i++) {
+    ulSize = (uint32_t)(xTaskStatus[i].pxEndOfStack - xTaskStatus[i].pxStackBase) + 1;
+    vConsolePrintfBlocking("#STK:%u %u %s\n", ulSize,
+                           ulSize - (uint32_t)xTaskStatus[i].usStackHighWaterMark, xTaskStatus[i].pcTaskName);
+  }
+
+#if ( configASSERT_DEFINED == 1 )
+  vConsolePrintfBlocking("#STK:%u %u (ISR)\n", ulStackMonitorIsrSize(), ulStackMonitorIsrPeak());
+#endif
+
+  if (uxTasks == 0) {
+    vConsolePrintfBlocking("WARNING! increase 'configSTACK_MONITOR_MAX_TASKS'\n");
+  }
+}
+
+
+#if ( configUSE_STACK_MONITOR == 1 )
+/******************************************************************************
+ * Monitor task: periodically print the stack report.
+ ******************************************************************************/
+static void prvStackMonitorTask(void *pvParameters) {
+
+  TickType_t xLastWakeTime = xTaskGetTickCount();
+
+  (void)pvParameters;
+
+  for (;;) {
+    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(configSTACK_MONITOR_PERIOD_MS));
+    vStackMonitorReport();
+  }
+}
+#endif
+
+
+/******************************************************************************
+ * Create the stack monitor task (if enabled).
+ ******************************************************************************/
+void vStackMonitorStart(void) {
+
+#if ( configUSE_STACK_MONITOR == 1 )
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  static StaticTask_t xStackMonitorTCB configSTATIC_DATA;
+  static StackType_t xStackMonitorStack[configMINIMAL_STACK_SIZE] configSTATIC_DATA;
+  xTaskCreateStatic(prvStackMonitorTask, "Stk", configMINIMAL_STACK_SIZE, NULL, configSTACK_MONITOR_PRIORITY, xStackMonitorStack, &xStackMonitorTCB);
+#else
+  xTaskCreate(prvStackMonitorTask, "Stk", configMINIMAL_STACK_SIZE, NULL, configSTACK_MONITOR_PRIORITY, NULL);
+#endif
+#endif
+}
@@ -0,0 +1,34 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Stack high-water-mark monitor
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * The kernel paints every task stack with 0xa5 when the task is created and
+ * the RISC-V port paints the ISR stack (configISR_STACK_SIZE_WORDS) with 0xee
+ * when the scheduler is started (only if configASSERT is defined). The
+ * high-water mark is the number of words that have never been overwritten.
+ *
+ * vStackMonitorReport() prints the size and the peak usage (in words) of
+ * every task stack and of the ISR stack as "#STK" lines:
+ *
+ *   #STK:<size> <peak used> <name>
+ *
+ * If configUSE_STACK_MONITOR is enabled a monitor task prints the report
+ * periodically. tools/stack_report.py collects the reports of a (long) run
+ * and recommends stack sizes including a safety margin.
+ ******************************************************************************/
+
+#ifndef STACK_MONITOR_H
+#define STACK_MONITOR_H
+
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+
+uint32_t ulStackMonitorIsrSize(void);
+uint32_t ulStackMonitorIsrPeak(void);
+void vStackMonitorReport(void);
+void vStackMonitorStart(void);
+
+#endif /* STACK_MONITOR_H */
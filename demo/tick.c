@@ -0,0 +1,56 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Kernel tick on the CLINT MTIME timer
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Tick API */
+#include "platform.h"
+#include "tick.h"
+
+#if ( configNUMBER_OF_CORES == 1 )
+
+/* Tick state (see tick.h) */
+uint64_t ullTickNextTime = 0;
+uint32_t ulTickIncrement = 0;
+
+
+/******************************************************************************
+ * Program the first tick (called by the kernel when the scheduler starts).
+ ******************************************************************************/
+void vPortSetupTimerInterrupt(void) {
+
+  ulTickIncrement = ulPlatformDivU32(ulPlatformClockHz, configTICK_RATE_HZ);
+
+  ullTickNextTime = ullTickGetTime() + ulTickIncrement;
+  vTickSetCompare(ullTickNextTime);
+  ullTickNextTime += ulTickIncrement;
+
+  neorv32_cpu_csr_set(CSR_MIE, 1 << CSR_MIE_MTIE);
+}
+
+
+/******************************************************************************
+ * Tick interrupt (called from freertos_risc_v_application_interrupt_handler).
+ ******************************************************************************/
+configFAST_TEXT void vTickInterruptHandler(void) {
+
+  vTickSetCompare(ullTickNextTime);
+  ullTickNextTime += ulTickIncrement;
+
+  if (xTaskIncrementTick() != pdFALSE) {
+    vTaskSwitchContext();
+  }
+}
+
+#endif /* configNUMBER_OF_CORES == 1 */
@@ -0,0 +1,66 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Kernel tick on the CLINT MTIME timer
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * The generic RISC-V port computes the tick increment from
+ * configCPU_CLOCK_HZ at compile time. Here the increment is derived from the
+ * SYSINFO clock at boot, so the port's own MTIME tick is disabled
+ * (configMTIMECMP_BASE_ADDRESS = 0, portasmHAS_MTIME = 0) and the timer
+ * interrupt is handled by freertos_risc_v_application_interrupt_handler().
+ * The state below has its own names so it cannot clash with the port's
+ * (unused) ullNextTime / uxTimerIncrementsForOneTick.
+ *
+ * Tick state (also used by tickless.c):
+ *  - MTIMECMP holds the time of the next tick
+ *  - ullTickNextTime holds the time of the tick after that; the tick interrupt
+ *    copies it to MTIMECMP and advances it by ulTickIncrement
+ ******************************************************************************/
+
+#ifndef TICK_H
+#define TICK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* CLINT MTIME and MTIMECMP of hart 0 */
+#define tickMTIME               ( ( volatile uint32_t * )( NEORV32_CLINT_BASE + 0xbff8u ) )
+#define tickMTIMECMP            ( ( volatile uint32_t * )( NEORV32_CLINT_BASE + 0x4000u ) )
+
+extern uint64_t ullTickNextTime;
+extern uint32_t ulTickIncrement;
+
+void vPortSetupTimerInterrupt(void);
+void vTickInterruptHandler(void);
+
+
+/******************************************************************************
+ * Get the current 64-bit MTIME value.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) uint64_t ullTickGetTime(void) {
+
+  uint32_t ulHigh, ulLow;
+
+  do {
+    ulHigh = tickMTIME[1];
+    ulLow  = tickMTIME[0];
+  } while (ulHigh != tickMTIME[1]);
+
+  return ((uint64_t)ulHigh << 32) | (uint64_t)ulLow;
+}
+
+
+/******************************************************************************
+ * Update the 64-bit MTIMECMP value without creating a spurious interrupt.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vTickSetCompare(uint64_t ullTime) {
+
+  tickMTIMECMP[0] = 0xffffffffu;
+  tickMTIMECMP[1] = (uint32_t)(ullTime >> 32);
+  tickMTIMECMP[0] = (uint32_t)ullTime;
+}
+
+#endif /* TICK_H */
@@ -0,0 +1,100 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Tickless idle for the CLINT MTIME tick
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * When all tasks are blocked for at least configEXPECTED_IDLE_TIME_BEFORE_SLEEP
+ * ticks the kernel calls portSUPPRESS_TICKS_AND_SLEEP(). The MTIMECMP
+ * register is then moved to the next required wake-up time and the CPU goes
+ * to sleep. After wake-up (by the timer or by any other interrupt) the tick
+ * count is corrected from MTIME.
+ *
+ * The MTIMECMP register and ullTickNextTime (see tick.h) are kept consistent
+ * here so the regular tick interrupt just continues from wherever the sleep
+ * period ended.
+ *
+ * No additional timer is required: MTIMECMP is 64-bit wide so the sleep time
+ * is only limited by the 32-bit arithmetic used to compute the number of
+ * elapsed ticks (~42s at 100MHz).
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Tick state and detected ISA */
+#include "platform.h"
+#include "tick.h"
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+
+/******************************************************************************
+ * Stop the tick for (up to) xExpectedIdleTime ticks and sleep.
+ ******************************************************************************/
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime) {
+
+  const uint32_t ulIncrement = ulTickIncrement;
+  const TickType_t xMaxIdleTime = (TickType_t)ulPlatformDivU32(0xffffffffu, ulIncrement) - 1;
+  uint64_t ullTickTime, ullWakeTime, ullNow;
+  TickType_t xElapsed;
+  TickType_t xModifiableIdleTime;
+
+  if (xExpectedIdleTime > xMaxIdleTime) {
+    xExpectedIdleTime = xMaxIdleTime;
+  }
+
+  // interrupts stay disabled during sleep; wfi still wakes up on any enabled + pending interrupt
+  __asm volatile ("csrc mstatus, 8");
+
+  // a task might have been made ready in the meantime
+  if (eTaskConfirmSleepModeStatus() == eAbortSleep) {
+    __asm volatile ("csrs mstatus, 8");
+    return;
+  }
+
+  // MTIMECMP currently holds the time of the next regular tick
+  ullTickTime = ullTickNextTime - ulIncrement;
+  ullWakeTime = ullTickTime + ullPlatformMulU32(xExpectedIdleTime - 1, ulIncrement);
+  vTickSetCompare(ullWakeTime);
+
+  xModifiableIdleTime = xExpectedIdleTime;
+  configPRE_SLEEP_PROCESSING(xModifiableIdleTime);
+  if (xModifiableIdleTime > 0) {
+    neorv32_cpu_sleep();
+  }
+  configPOST_SLEEP_PROCESSING(xExpectedIdleTime);
+
+  ullNow = ullTickGetTime();
+
+  if (ullNow >= ullWakeTime) {
+    // woken by the timer: the pending tick interrupt accounts for the last tick
+    // and reloads MTIMECMP from ullTickNextTime
+    ullTickNextTime = ullWakeTime + ulIncrement;
+    vTaskStepTick(xExpectedIdleTime - 1);
+  }
+  else {
+    // woken by another interrupt: count the tick periods that have completed
+    // and resume the regular tick at the next tick boundary
+    if (ullNow < ullTickTime) {
+      xElapsed = 0;
+    }
+    else {
+      xElapsed = (TickType_t)ulPlatformDivU32((uint32_t)(ullNow - ullTickTime), ulIncrement) + 1;
+    }
+    ullTickTime += ullPlatformMulU32(xElapsed, ulIncrement);
+    vTickSetCompare(ullTickTime);
+    ullTickNextTime = ullTickTime + ulIncrement;
+    vTaskStepTick(xElapsed);
+  }
+
+  __asm volatile ("csrs mstatus, 8");
+}
+
+#endif /* configUSE_TICKLESS_IDLE */
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+# Regression check for the NEORV32 FreeRTOS kernel micro-benchmarks
+# https://github.com/stnolting/neorv32-freertos
+# *****************************************************************************
+# Extracts the "#BENCH:" result lines (benchmark.c) from a console capture or
+# the GHDL simulation log and compares the minimum and average cycle counts
+# against a baseline file (a file written with --update or the log of a
+# baseline run). Exits with a non-zero code if a result got slower by more
+# than the given tolerance, if a benchmark is missing, if there is no
+# baseline or if the run did not complete.
+#
+# Usage: bench_compare.py ghdl.log baseline.txt [--tolerance PERCENT] [--update]
+# *****************************************************************************
+
+import argparse
+import os
+import sys
+
+
+def parse(lines):
+    """Return ({name: (min, avg, max)}, complete)."""
+    results = {}
+    complete = False
+    for line in lines:
+        if '#BENCH-END' in line:
+            complete = True
+        elif '#BENCH:' in line:
+            fields = line.split('#BENCH:', 1)[1].split()
+            try:
+                results[fields[0]] = tuple(int(f) for f in fields[1:4])
+            except (ValueError, IndexError):
+                print('[bench] malformed line: %s' % line.strip())
+    return results, complete
+
+
+def write_baseline(path, results):
+    with open(path, 'w') as f:
+        f.write('# NEORV32 FreeRTOS kernel micro-benchmarks (bench.sh --update)\n')
+        f.write('# name min avg max [cycles]\n')
+        for name, values in results.items():
+            f.write('#BENCH:%s %u %u %u\n' % ((name,) + values))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare NEORV32 FreeRTOS benchmark results against a baseline.')
+    parser.add_argument('log', help='console capture / ghdl.log')
+    parser.add_argument('baseline', help='baseline file')
+    parser.add_argument('--tolerance', type=float, default=5.0, help='allowed slowdown in percent (default: 5)')
+    parser.add_argument('--update', action='store_true', help='store the current results as new baseline')
+    opts = parser.parse_args()
+
+    with open(opts.log, errors='replace') as f:
+        results, complete = parse(f)
+    if not complete or not results:
+        print('[bench] FAILED: benchmark did not complete')
+        return 1
+
+    if not opts.update and not os.path.exists(opts.baseline):
+        print('[bench] FAILED: no baseline %s (create it with --update)' % opts.baseline)
+        return 1
+
+    if opts.update:
+        write_baseline(opts.baseline, results)
+        print('[bench] baseline written to %s' % opts.baseline)
+        for name, values in results.items():
+            print('  %-18s %8u %8u %8u' % ((name,) + values))
+        return 0
+
+    with open(opts.baseline) as f:
+        baseline, _ = parse(f)
+
+    failed = False
+    print('  %-18s %17s %17s %8s' % ('benchmark', 'min (base)', 'avg (base)', 'max'))
+    for name, (bmin, bavg, bmax) in baseline.items():
+        if name not in results:
+            print('  %-18s MISSING' % name)
+            failed = True
+            continue
+        rmin, ravg, rmax = results[name]
+        verdict = ''
+        for (value, base) in ((rmin, bmin), (ravg, bavg)):
+            if value > base * (1.0 + opts.tolerance / 100.0):
+                verdict = '  <-- REGRESSION'
+                failed = True
+        print('  %-18s %8u (%6u) %8u (%6u) %8u%s' % (name, rmin, bmin, ravg, bavg, rmax, verdict))
+    for name in results:
+        if name not in baseline:
+            print('  %-18s new: %u %u %u' % ((name,) + results[name]))
+
+    print('[bench] %s' % ('FAILED' if failed else 'PASSED'))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+# Decoder for the NEORV32 FreeRTOS deferred binary log (binlog.c)
+# https://github.com/stnolting/neorv32-freertos
+# *****************************************************************************
+# Reads a console capture (or the GHDL simulation log) and replaces every
+# "#BL:" record line with the formatted message. Format strings (and "%s"
+# arguments) are fetched from main.elf. All other lines are passed through.
+#
+# Usage: binlog_decode.py main.elf [console.log] [--clock HZ]
+# *****************************************************************************
+
+import argparse
+import re
+import sys
+
+from neorv32elf import Elf
+
+FORMAT_RE = re.compile(r'%([-0]*)(\d*)l?([cdiuxXsp%])')
+
+
+def to_signed(v):
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+def format_record(elf, fmt, args):
+    args = list(args)
+
+    def conv(m):
+        flags, width, spec = m.group(1), m.group(2), m.group(3)
+        if spec == '%':
+            return '%'
+        v = args.pop(0) if args else 0
+        if spec in 'di':
+            text = str(to_signed(v))
+        elif spec == 'u':
+            text = str(v)
+        elif spec == 'x':
+            text = '%x' % v
+        elif spec == 'X':
+            text = '%X' % v
+        elif spec == 'p':
+            return '%08x' % v
+        elif spec == 'c':
+            text = chr(v & 0xff)
+        else:  # 's'
+            text = elf.cstring(v)
+            if text is None:
+                text = '<0x%08x>' % v
+        w = int(width) if width else 0
+        if '-' in flags:
+            return text.ljust(w)
+        return text.rjust(w, '0' if ('0' in flags and spec not in 'sc') else ' ')
+
+    return FORMAT_RE.sub(conv, fmt)
+
+
+class Unwrapper:
+    """Extend 32-bit MTIME stamps to 64 bit (records may arrive slightly out of order)."""
+
+    def __init__(self):
+        self.last = None
+
+    def __call__(self, stamp):
+        if self.last is None:
+            self.last = stamp
+            return stamp
+        base = (self.last & ~0xffffffff) | stamp
+        ext = min((base - (1 << 32), base, base + (1 << 32)), key=lambda c: abs(c - self.last))
+        self.last = max(self.last, ext)
+        return ext
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode NEORV32 FreeRTOS binary log records.')
+    parser.add_argument('elf', help='firmware ELF file (main.elf)')
+    parser.add_argument('log', nargs='?', help='console capture / ghdl.log (default: stdin)')
+    parser.add_argument('--clock', type=float, default=100e6, help='MTIME clock in Hz (default: 100 MHz)')
+    parser.add_argument('--only', action='store_true', help='suppress non-log lines')
+    opts = parser.parse_args()
+
+    elf = Elf(opts.elf)
+    unwrap = Unwrapper()
+    src = open(opts.log, errors='replace') if opts.log else sys.stdin
+
+    for line in src:
+        if '#BLD:' in line:
+            words = [int(w, 16) for w in line.split('#BLD:', 1)[1].split()]
+            print('[binlog] records dropped: %u (ISR), %u (task)' % (words[0], words[1]))
+            continue
+        if '#BL:' not in line:
+            if not opts.only:
+                sys.stdout.write(line)
+            continue
+        try:
+            words = [int(w, 16) for w in line.split('#BL:', 1)[1].split()]
+            header, stamp, args = words[0], words[1], words[2:]
+        except (ValueError, IndexError):
+            print('[binlog] malformed record: %s' % line.strip())
+            continue
+        fmt = elf.cstring(header & ~3)
+        if fmt is None:
+            text = '<unknown format 0x%08x> %s' % (header & ~3, ' '.join('%08x' % a for a in args))
+        else:
+            text = format_record(elf, fmt, args[:header & 3])
+        print('[%12.6f] %s' % (unwrap(stamp) / opts.clock, text))
+
+
+if __name__ == '__main__':
+    main()
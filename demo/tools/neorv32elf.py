@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+# Minimal ELF32 (little-endian) reader for the NEORV32 FreeRTOS host tools
+# https://github.com/stnolting/neorv32-freertos
+# *****************************************************************************
+# Provides read access to the loaded sections (e.g. to fetch format strings
+# from .rodata) and address-to-symbol lookup. Only depends on the Python
+# standard library so no extra packages are required.
+# *****************************************************************************
+
+import bisect
+import struct
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+STT_OBJECT = 1
+STT_FUNC = 2
+
+
+class Elf:
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError('%s: not a 32-bit little-endian ELF file' % path)
+
+        (e_shoff,) = struct.unpack_from('<I', self.data, 0x20)
+        e_shentsize, e_shnum, e_shstrndx = struct.unpack_from('<HHH', self.data, 0x2e)
+
+        raw = []
+        for i in range(e_shnum):
+            raw.append(struct.unpack_from('<IIIIIIIIII', self.data, e_shoff + i * e_shentsize))
+        strtab_off = raw[e_shstrndx][4]
+
+        self.sections = []
+        for (name, stype, flags, addr, offset, size, link, info, align, entsize) in raw:
+            self.sections.append({'name': self._str(strtab_off + name), 'type': stype, 'flags': flags,
+                                  'addr': addr, 'offset': offset, 'size': size, 'link': link,
+                                  'entsize': entsize})
+        self._symbols = None
+
+    def _str(self, offset):
+        end = self.data.index(b'\x00', offset)
+        return self.data[offset:end].decode('ascii', 'replace')
+
+    def section(self, name):
+        for s in self.sections:
+            if s['name'] == name:
+                return s
+        return None
+
+    def read(self, addr, size):
+        """Read bytes from a loaded (allocated) section; returns None if not mapped."""
+        for s in self.sections:
+            if (s['flags'] & SHF_ALLOC) and s['type'] != SHT_NOBITS and s['addr'] <= addr < s['addr'] + s['size']:
+                start = s['offset'] + (addr - s['addr'])
+                return self.data[start:start + min(size, s['addr'] + s['size'] - addr)]
+        return None
+
+    def cstring(self, addr, limit=256):
+        """Read a zero-terminated string from a loaded section; returns None if not mapped."""
+        raw = self.read(addr, limit)
+        if raw is None:
+            return None
+        return raw.split(b'\x00', 1)[0].decode('ascii', 'replace')
+
+    def symbols(self):
+        """List of (address, size, name, type) for all function and object symbols, sorted by address."""
+        if self._symbols is None:
+            self._symbols = []
+            for s in self.sections:
+                if s['type'] != SHT_SYMTAB:
+                    continue
+                strtab = self.sections[s['link']]['offset']
+                for i in range(s['size'] // 16):
+                    name, value, size, info, other, shndx = struct.unpack_from('<IIIBBH', self.data, s['offset'] + i * 16)
+                    stype = info & 0xf
+                    if stype in (STT_FUNC, STT_OBJECT) and name != 0:
+                        self._symbols.append((value, size, self._str(strtab + name), stype))
+            self._symbols.sort()
+            self._func_addrs = [sym[0] for sym in self._symbols if sym[3] == STT_FUNC]
+            self._func_syms = [sym for sym in self._symbols if sym[3] == STT_FUNC]
+        return self._symbols
+
+    def symbol_address(self, name):
+        for (addr, size, sname, stype) in self.symbols():
+            if sname == name:
+                return addr
+        return None
+
+    def function(self, addr):
+        """Return (name, offset) of the function containing addr, or (None, None)."""
+        self.symbols()
+        i = bisect.bisect_right(self._func_addrs, addr) - 1
+        if i < 0:
+            return (None, None)
+        start, size, name, stype = self._func_syms[i]
+        if size != 0 and addr >= start + size:
+            return (None, None)
+        return (name, addr - start)
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+# Code placement report for the NEORV32 FreeRTOS demo
+# https://github.com/stnolting/neorv32-freertos
+# *****************************************************************************
+# Lists the kernel fast-path functions selected by fast_text.ld together with
+# their size and whether they are executed from IMEM (.fast_text) or from the
+# default .text section, and compares the size of the fast path against the
+# IMEM size. For "PLACEMENT=imem" builds (no .fast_text section) the report
+# shows how much IMEM the fast path would need.
+#
+# Usage: placement_report.py main.elf [--ld fast_text.ld] [--imem-size BYTES]
+# *****************************************************************************
+
+import argparse
+import os
+import re
+import sys
+
+from neorv32elf import Elf, STT_FUNC
+
+
+def fast_path(ld_path):
+    """Function names selected by the linker script (in order)."""
+    names = []
+    with open(ld_path) as f:
+        for line in f:
+            for name in re.findall(r'\.text\.([A-Za-z_]\w*)\b(?!\.)', line):
+                if name != 'fast' and name not in names:
+                    names.append(name)
+    return names
+
+
+def size_arg(text):
+    text = text.lower()
+    if text.endswith('k'):
+        return int(text[:-1], 0) * 1024
+    return int(text, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Report the placement of the NEORV32 FreeRTOS kernel fast path.')
+    parser.add_argument('elf', help='main.elf')
+    parser.add_argument('--ld', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'fast_text.ld'),
+                        help='code placement linker script (default: fast_text.ld)')
+    parser.add_argument('--imem-size', type=size_arg, default=16 * 1024, help='IMEM size in bytes (default: 16k)')
+    opts = parser.parse_args()
+
+    elf = Elf(opts.elf)
+    functions = {}
+    for (addr, size, name, stype) in elf.symbols():
+        if stype == STT_FUNC:
+            functions[name] = (addr, size)
+
+    fast = elf.section('.fast_text')
+    text = elf.section('.text')
+
+    def in_fast(addr):
+        return fast is not None and fast['addr'] <= addr < fast['addr'] + fast['size']
+
+    print('  %-32s %6s  %s' % ('function', 'bytes', 'placement'))
+    total = 0
+    missing = []
+    for name in fast_path(opts.ld):
+        if name not in functions:
+            missing.append(name)
+            continue
+        addr, size = functions[name]
+        total += size
+        print('  %-32s %6u  %s' % (name, size, 'IMEM' if in_fast(addr) else '.text (%s)' % ('flash' if fast else 'IMEM')))
+
+    if fast is not None:
+        others = fast['size'] - sum(functions[n][1] for n in fast_path(opts.ld) if n in functions and in_fast(functions[n][0]))
+        print('  %-32s %6u  IMEM' % ('(trap entry, configFAST_TEXT)', others))
+        print('\n.fast_text: %u of %u bytes IMEM (%.1f%%), .text in flash: %u bytes' %
+              (fast['size'], opts.imem_size, 100.0 * fast['size'] / opts.imem_size, text['size'] if text else 0))
+    else:
+        print('\nkernel fast path: %u bytes = %.1f%% of %u bytes IMEM (all code in IMEM: %u bytes)' %
+              (total, 100.0 * total / opts.imem_size, opts.imem_size, text['size'] if text else 0))
+    if missing:
+        print('not linked (inlined or unused): %s' % ', '.join(missing))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+# Report generator for the NEORV32 FreeRTOS PC-sampling profiler (profiler.c)
+# https://github.com/stnolting/neorv32-freertos
+# *****************************************************************************
+# Reads a console capture (or the GHDL simulation log) containing one or more
+# profiler dumps, adds up the samples of all dumps, maps the sampled program
+# counters to functions using the firmware ELF file and prints
+#
+# - a flat profile (samples per function, over all tasks)
+# - a per-task profile (samples per task and the hottest functions of each)
+# - optionally the hottest instructions (--pcs)
+#
+# Usage: profile.py main.elf [console.log] [--top N] [--pcs N]
+# *****************************************************************************
+
+import argparse
+import collections
+import sys
+
+from neorv32elf import Elf
+
+# pseudo task indices (keep in sync with profiler.h)
+TASK_OTHER = 0xfe
+TASK_ISR = 0xff
+
+
+def percent(part, total):
+    return 100.0 * part / total if total else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Symbolize NEORV32 FreeRTOS profiler dumps.')
+    parser.add_argument('elf', help='firmware ELF file (main.elf)')
+    parser.add_argument('log', nargs='?', help='console capture / ghdl.log (default: stdin)')
+    parser.add_argument('--top', type=int, default=20, help='functions per profile (default: 20)')
+    parser.add_argument('--pcs', type=int, default=0, help='also list the N hottest instructions')
+    opts = parser.parse_args()
+
+    elf = Elf(opts.elf)
+    src = open(opts.log, errors='replace') if opts.log else sys.stdin
+
+    pcs = collections.Counter()    # (task name, pc) -> samples
+    names = {}                     # task index -> name (of the current dump)
+    dumps = samples = lost = 0
+    rate = None
+
+    for line in src:
+        try:
+            if '#PFC:' in line:
+                words = [int(w) for w in line.split('#PFC:', 1)[1].split()]
+                rate, samples, lost = words[1], samples + words[2], lost + words[3]
+                names = {TASK_OTHER: '(other)', TASK_ISR: '(ISR)'}
+            elif '#PFT:' in line:
+                fields = line.split('#PFT:', 1)[1].split(None, 2)
+                names[int(fields[0])] = fields[2].strip() if len(fields) > 2 else '?'
+            elif '#PFE:' in line:
+                dumps += 1
+            elif '#PF:' in line:
+                words = line.split('#PF:', 1)[1].split()
+                task = int(words[1])
+                pcs[(names.get(task, 'task %u' % task), int(words[0], 16))] += int(words[2])
+        except (ValueError, IndexError):
+            sys.stderr.write('[profile] malformed line: %s\n' % line.strip())
+
+    if not dumps:
+        sys.exit('no profiler dumps found (build with -DconfigUSE_PROFILER=1)')
+
+    flat = collections.Counter()
+    tasks = collections.defaultdict(collections.Counter)
+    for (task, pc), count in pcs.items():
+        name, offset = elf.function(pc)
+        func = name if name is not None else '0x%08x' % pc
+        flat[func] += count
+        tasks[task][func] += count
+    total = sum(flat.values())
+
+    print('%u dumps, %u samples at %u Hz (%u lost, %.1f%%)' % (dumps, samples, rate, lost, percent(lost, samples)))
+
+    print('\nFlat profile:\n')
+    print('  %8s %7s  %s' % ('samples', '%', 'function'))
+    for func, count in flat.most_common(opts.top):
+        print('  %8u %6.2f%%  %s' % (count, percent(count, total), func))
+
+    print('\nPer-task profile:')
+    for task, funcs in sorted(tasks.items(), key=lambda t: -sum(t[1].values())):
+        task_total = sum(funcs.values())
+        print('\n  %s: %u samples (%.2f%%)' % (task, task_total, percent(task_total, total)))
+        for func, count in funcs.most_common(opts.top):
+            print('    %8u %6.2f%%  %s' % (count, percent(count, task_total), func))
+
+    if opts.pcs:
+        hot = collections.Counter()
+        for (task, pc), count in pcs.items():
+            hot[pc] += count
+        print('\nHottest instructions:\n')
+        for pc, count in hot.most_common(opts.pcs):
+            name, offset = elf.function(pc)
+            where = '%s+0x%x' % (name, offset) if name is not None else '?'
+            print('  0x%08x %8u %6.2f%%  %s' % (pc, count, percent(count, total), where))
+
+
+if __name__ == '__main__':
+    main()
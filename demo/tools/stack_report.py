@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+# Stack size recommendations for the NEORV32 FreeRTOS demo
+# https://github.com/stnolting/neorv32-freertos
+# *****************************************************************************
+# Collects the "#STK:" lines (stack_monitor.c) of a console capture or of the
+# GHDL simulation log, takes the peak usage of each stack over all reports and
+# recommends a stack size (in words) including a safety margin. The result
+# is only as good as the run: use a long soak run that exercises all code
+# paths (and interrupt load) of the application.
+#
+# Usage: stack_report.py ghdl.log [--margin PERCENT] [--min-extra WORDS]
+# *****************************************************************************
+
+import argparse
+import math
+import sys
+
+# stack sizes are kept 16-byte aligned (RISC-V ABI)
+ALIGN_WORDS = 4
+
+# the kernel's overflow check (configCHECK_FOR_STACK_OVERFLOW = 2) needs the
+# lowest words of a task stack to keep their fill pattern
+GUARD_WORDS = 4
+
+# configuration options of the kernel-owned stacks
+CONFIG_NAMES = {
+    'IDLE': 'configMINIMAL_STACK_SIZE',
+    'Tmr Svc': 'configTIMER_TASK_STACK_DEPTH',
+    '(ISR)': 'configISR_STACK_SIZE_WORDS',
+}
+
+
+def parse(lines):
+    """Return {name: [size, peak, reports]} (in order of appearance)."""
+    stacks = {}
+    for line in lines:
+        if '#STK:' not in line:
+            continue
+        fields = line.split('#STK:', 1)[1].rstrip('\r\n').split(' ', 2)
+        try:
+            size, peak, name = int(fields[0]), int(fields[1]), fields[2]
+        except (ValueError, IndexError):
+            print('[stack] malformed line: %s' % line.strip())
+            continue
+        entry = stacks.setdefault(name, [size, 0, 0])
+        entry[0] = size
+        entry[1] = max(entry[1], peak)
+        entry[2] += 1
+    return stacks
+
+
+def recommend(name, peak, margin, min_extra):
+    """Peak usage plus margin (at least min_extra words), aligned."""
+    words = peak + max(int(math.ceil(peak * margin / 100.0)), min_extra)
+    if name != '(ISR)':
+        words += GUARD_WORDS
+    return ((words + ALIGN_WORDS - 1) // ALIGN_WORDS) * ALIGN_WORDS
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Recommend NEORV32 FreeRTOS stack sizes from stack monitor reports.')
+    parser.add_argument('log', help='console capture / ghdl.log')
+    parser.add_argument('--margin', type=float, default=25.0, help='safety margin in percent of the peak usage (default: 25)')
+    parser.add_argument('--min-extra', type=int, default=16, help='minimum safety margin in words (default: 16)')
+    opts = parser.parse_args()
+
+    with open(opts.log, errors='replace') as f:
+        stacks = parse(f)
+    if not stacks:
+        print('[stack] no stack reports found (enable configUSE_STACK_MONITOR or call vStackMonitorReport())')
+        return 1
+
+    reports = max(entry[2] for entry in stacks.values())
+    print('[stack] %u report(s), margin %.0f%% (min. %u words), sizes in words' % (reports, opts.margin, opts.min_extra))
+    print('  %-16s %6s %6s %6s %7s' % ('stack', 'size', 'peak', 'recom.', 'saving'))
+
+    saturated = False
+    total = 0
+    for name, (size, peak, _) in stacks.items():
+        words = recommend(name, peak, opts.margin, opts.min_extra)
+        note = ''
+        if peak >= size:
+            note = '  <-- SATURATED (overflow or not painted)'
+            saturated = True
+        elif words > size:
+            note = '  <-- too small'
+        total += size - words
+        print('  %-16s %6u %6u %6u %7d%s' % (name, size, peak, words, size - words, note))
+    print('  %-16s %27d words (%d bytes)' % ('total', total, total * 4))
+
+    suggestions = [(CONFIG_NAMES[name], recommend(name, stacks[name][1], opts.margin, opts.min_extra))
+                   for name in CONFIG_NAMES if name in stacks]
+    if suggestions:
+        print('\nFreeRTOSConfig.h:')
+        for option, words in suggestions:
+            print('  #define %-32s ( %u )' % (option, words))
+        print('(configMINIMAL_STACK_SIZE is also used by other tasks - check their peaks)')
+
+    return 1 if saturated else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+# Converter for the NEORV32 FreeRTOS kernel event trace (trace.c)
+# https://github.com/stnolting/neorv32-freertos
+# *****************************************************************************
+# Reads a console capture (or the GHDL simulation log) containing one or more
+# trace dumps and writes a Chrome trace event file (JSON) that can be opened
+# with https://ui.perfetto.dev or chrome://tracing.
+#
+# Every task becomes a track showing when it was running; interrupts and
+# scheduler ticks are shown on a separate "Interrupts" track and queue /
+# notification events are added as instant events to the running task.
+#
+# Usage: trace2json.py [console.log] [-o trace.json] [--elf main.elf]
+# *****************************************************************************
+
+import argparse
+import json
+import sys
+
+from binlog_decode import Unwrapper
+
+# event IDs (keep in sync with trace.h)
+EVENTS = {
+    1: 'task switched in',
+    2: 'task create',
+    3: 'task delete',
+    4: 'delay',
+    5: 'delay until',
+    6: 'queue send',
+    7: 'queue send failed',
+    8: 'queue receive',
+    9: 'queue receive failed',
+    10: 'blocking on queue send',
+    11: 'blocking on queue receive',
+    12: 'queue send from ISR',
+    13: 'queue receive from ISR',
+    14: 'notify',
+    15: 'notify from ISR',
+    16: 'notify wait',
+    17: 'tick',
+    18: 'ISR enter',
+    19: 'ISR exit',
+    20: 'ISR exit to scheduler',
+}
+EVT_SWITCHED_IN, EVT_TICK, EVT_ISR_ENTER, EVT_ISR_EXIT = 1, 17, 18, 19
+IRQ_TID = 0
+
+
+def irq_name(cause):
+    if cause >= 16:
+        return 'FIRQ %u' % (cause - 16)
+    return 'IRQ %u' % cause
+
+
+class Converter:
+
+    def __init__(self, elf=None):
+        self.elf = elf
+        self.clock = 100e6
+        self.unwrap = Unwrapper()
+        self.names = {}
+        self.tids = {}
+        self.events = []
+        self.running = None  # (tid, start time)
+        self.in_isr = False
+        self.last = 0
+
+    def us(self, time):
+        return time * 1e6 / self.clock
+
+    def obj_name(self, obj):
+        if obj in self.names:
+            return self.names[obj]
+        if self.elf is not None:
+            for (addr, size, name, stype) in self.elf.symbols():
+                if addr <= obj < addr + max(size, 1):
+                    return name if addr == obj else '%s+%u' % (name, obj - addr)
+        return '0x%08x' % obj
+
+    def tid(self, tcb):
+        if tcb not in self.tids:
+            self.tids[tcb] = len(self.tids) + 1
+        return self.tids[tcb]
+
+    def close_running(self, time):
+        if self.running is not None:
+            tid, start = self.running
+            self.events.append({'name': 'running', 'ph': 'X', 'pid': 1, 'tid': tid,
+                                'ts': self.us(start), 'dur': self.us(time - start)})
+            self.running = None
+
+    def record(self, stamp, word, obj):
+        time = self.unwrap(stamp)
+        self.last = time
+        event, arg = word & 0xff, word >> 8
+        name = EVENTS.get(event, 'event %u' % event)
+
+        if event == EVT_SWITCHED_IN:
+            self.close_running(time)
+            self.running = (self.tid(obj), time)
+        elif event == EVT_ISR_ENTER:
+            self.in_isr = True
+            self.events.append({'name': irq_name(arg), 'ph': 'B', 'pid': 1, 'tid': IRQ_TID, 'ts': self.us(time)})
+        elif event == EVT_ISR_EXIT:
+            if self.in_isr:
+                self.events.append({'ph': 'E', 'pid': 1, 'tid': IRQ_TID, 'ts': self.us(time)})
+            self.in_isr = False
+        elif event == EVT_TICK:
+            self.events.append({'name': name, 'ph': 'i', 's': 't', 'pid': 1, 'tid': IRQ_TID,
+                                'ts': self.us(time), 'args': {'tick': arg}})
+        else:
+            tid = IRQ_TID if (self.in_isr or self.running is None) else self.running[0]
+            args = {'object': self.obj_name(obj)} if obj else {}
+            if arg:
+                args['arg'] = arg
+            self.events.append({'name': name, 'ph': 'i', 's': 't', 'pid': 1, 'tid': tid,
+                                'ts': self.us(time), 'args': args})
+
+    def end_of_dump(self):
+        self.close_running(self.last)
+        if self.in_isr:
+            self.events.append({'ph': 'E', 'pid': 1, 'tid': IRQ_TID, 'ts': self.us(self.last)})
+            self.in_isr = False
+
+    def result(self):
+        meta = [{'name': 'process_name', 'ph': 'M', 'pid': 1, 'args': {'name': 'NEORV32 FreeRTOS'}},
+                {'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': IRQ_TID, 'args': {'name': 'Interrupts'}}]
+        for tcb, tid in self.tids.items():
+            meta.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': tid,
+                         'args': {'name': self.names.get(tcb, 'task 0x%08x' % tcb)}})
+        return {'traceEvents': meta + self.events, 'displayTimeUnit': 'ns'}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert NEORV32 FreeRTOS trace dumps to Chrome/Perfetto JSON.')
+    parser.add_argument('log', nargs='?', help='console capture / ghdl.log (default: stdin)')
+    parser.add_argument('-o', '--output', help='output file (default: stdout)')
+    parser.add_argument('--elf', help='firmware ELF file (main.elf) to name statically allocated objects')
+    opts = parser.parse_args()
+
+    elf = None
+    if opts.elf:
+        from neorv32elf import Elf
+        elf = Elf(opts.elf)
+
+    conv = Converter(elf)
+    src = open(opts.log, errors='replace') if opts.log else sys.stdin
+    records = 0
+
+    for line in src:
+        try:
+            if '#TRC:' in line:
+                conv.clock = float(line.split('#TRC:', 1)[1].split()[0])
+            elif '#TRN:' in line:
+                fields = line.split('#TRN:', 1)[1].split(None, 1)
+                conv.names[int(fields[0], 16)] = fields[1].strip() if len(fields) > 1 else '?'
+            elif '#TRE:' in line:
+                total = int(line.split('#TRE:', 1)[1].split()[0])
+                if total > records:
+                    sys.stderr.write('[trace] %u older records have been overwritten\n' % (total - records))
+                conv.end_of_dump()
+                records = 0
+            elif '#TR:' in line:
+                words = [int(w, 16) for w in line.split('#TR:', 1)[1].split()]
+                conv.record(words[0], words[1], words[2])
+                records += 1
+        except (ValueError, IndexError):
+            sys.stderr.write('[trace] malformed line: %s\n' % line.strip())
+
+    conv.end_of_dump()
+    dst = open(opts.output, 'w') if opts.output else sys.stdout
+    json.dump(conv.result(), dst)
+
+
+if __name__ == '__main__':
+    main()
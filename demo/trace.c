@@ -0,0 +1,112 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Kernel event trace recorder
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************/
+
+/* Standard libraries */
+#include <stdint.h>
+
+/* FreeRTOS kernel */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* NEORV32 HAL */
+#include <neorv32.h>
+
+/* Trace recorder and console */
+#include "trace.h"
+#include "stack_guard.h"
+#include "console.h"
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+#if ((configTRACE_BUFFER_RECORDS & (configTRACE_BUFFER_RECORDS - 1)) != 0)
+  #error "configTRACE_BUFFER_RECORDS has to be a power of two!"
+#endif
+
+/* Trace buffer */
+TraceRecord_t xTraceBuffer[configTRACE_BUFFER_RECORDS];
+volatile uint32_t ulTraceIndex = 0;
+volatile uint32_t ulTraceEnabled = 1;
+
+/* Prototypes */
+#if ( configTRACE_DUMP_PERIOD_MS > 0 )
+static void prvTraceTask(void *pvParameters);
+#endif
+
+
+/******************************************************************************
+ * Create the periodic dump task (if enabled). Recording is active from reset.
+ ******************************************************************************/
+void vTraceInit(void) {
+
+#if ( configTRACE_DUMP_PERIOD_MS > 0 )
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+  static StaticTask_t xTraceTCB configSTATIC_DATA;
+  static StackType_t xTraceStack[configMINIMAL_STACK_SIZE] configSTATIC_DATA;
+  xTaskCreateStatic(prvTraceTask, "Trace", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, xTraceStack, &xTraceTCB);
+#else
+  xTaskCreate(prvTraceTask, "Trace", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL);
+#endif
+#endif
+}
+
+
+/******************************************************************************
+ * Print the task names and all buffered records (oldest first). Recording is
+ * paused while dumping. Must be called from a task.
+ ******************************************************************************/
+void vTraceDump(void) {
+
+  static TaskStatus_t xStatus[configTRACE_MAX_TASKS];
+  UBaseType_t uxTasks, i;
+  uint32_t ulFirst, ulLast, ulGuard;
+  TraceRecord_t *pxRecord;
+
+  ulTraceEnabled = 0;
+
+  vConsolePrintfBlocking("#TRC:%u\n", (unsigned)NEORV32_SYSINFO->CLK);
+
+  // map TCB addresses to task names (no heap required)
+  ulGuard = ulStackGuardSuspend(); // the high-water mark scan reads the caller's guard area
+  uxTasks = uxTaskGetSystemState(xStatus, configTRACE_MAX_TASKS, NULL);
+  vStackGuardResume(ulGuard);
+  for (i = 0; i < uxTasks; i++) {
+    vConsolePrintfBlocking("#TRN:%08x %s\n", (unsigned)xStatus[i].xHandle, xStatus[i].pcTaskName);
+  }
+
+  ulLast = ulTraceIndex;
+  ulFirst = 0;
+  if (ulLast > configTRACE_BUFFER_RECORDS) {
+    ulFirst = ulLast - configTRACE_BUFFER_RECORDS;
+  }
+
+  while (ulFirst != ulLast) {
+    pxRecord = &xTraceBuffer[ulFirst++ & (configTRACE_BUFFER_RECORDS - 1)];
+    vConsolePrintfBlocking("#TR:%08x %08x %08x\n",
+                           (unsigned)pxRecord->ulTime, (unsigned)pxRecord->ulEvent, (unsigned)pxRecord->ulObject);
+  }
+  vConsolePrintfBlocking("#TRE:%u\n", (unsigned)ulLast);
+
+  ulTraceIndex = 0;
+  ulTraceEnabled = 1;
+}
+
+
+#if ( configTRACE_DUMP_PERIOD_MS > 0 )
+/******************************************************************************
+ * Trace task: periodically dump the trace buffer.
+ ******************************************************************************/
+static void prvTraceTask(void *pvParameters) {
+
+  (void)pvParameters;
+
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(configTRACE_DUMP_PERIOD_MS));
+    vTraceDump();
+  }
+}
+#endif
+
+#endif /* configUSE_TRACE_RECORDER */
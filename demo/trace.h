@@ -0,0 +1,123 @@
+/******************************************************************************
+ * FreeRTOS Demo for the NEORV32 RISC-V Processor
+ * Kernel event trace recorder
+ * https://github.com/stnolting/neorv32-freertos
+ ******************************************************************************
+ * Hooks the FreeRTOS trace macros and writes fixed-size, time-stamped records
+ * into a circular RAM buffer. Each record holds:
+ *
+ *   word 0: MTIME low word (processor clock cycles)
+ *   word 1: event ID (bits 7:0) | event argument (bits 31:8)
+ *   word 2: object (task control block, queue, ...)
+ *
+ * Recording costs a few loads/stores with interrupts masked, so it can be
+ * left enabled. vTraceDump() prints the buffer as "#TR" lines via the console
+ * (or into the GHDL simulation log); tools/trace2json.py converts them into
+ * the Chrome/Perfetto JSON trace format.
+ *
+ * This file is included by FreeRTOSConfig.h so the trace macros are visible
+ * to the kernel sources. It must not depend on any FreeRTOS types.
+ ******************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#include "irq_mask.h"
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+/* Event IDs (keep in sync with tools/trace2json.py) */
+#define traceEVT_TASK_SWITCHED_IN         ( 1 )  // obj: TCB, arg: priority
+#define traceEVT_TASK_CREATE              ( 2 )  // obj: TCB, arg: priority
+#define traceEVT_TASK_DELETE              ( 3 )  // obj: TCB
+#define traceEVT_TASK_DELAY               ( 4 )  // obj: current TCB
+#define traceEVT_TASK_DELAY_UNTIL         ( 5 )  // obj: current TCB, arg: wake-up tick
+#define traceEVT_QUEUE_SEND               ( 6 )  // obj: queue
+#define traceEVT_QUEUE_SEND_FAILED        ( 7 )  // obj: queue
+#define traceEVT_QUEUE_RECEIVE            ( 8 )  // obj: queue
+#define traceEVT_QUEUE_RECEIVE_FAILED     ( 9 )  // obj: queue
+#define traceEVT_BLOCKING_ON_QUEUE_SEND   ( 10 ) // obj: queue
+#define traceEVT_BLOCKING_ON_QUEUE_RECV   ( 11 ) // obj: queue
+#define traceEVT_QUEUE_SEND_FROM_ISR      ( 12 ) // obj: queue
+#define traceEVT_QUEUE_RECEIVE_FROM_ISR   ( 13 ) // obj: queue
+#define traceEVT_TASK_NOTIFY              ( 14 ) // obj: notified TCB, arg: index
+#define traceEVT_TASK_NOTIFY_FROM_ISR     ( 15 ) // obj: notified TCB, arg: index
+#define traceEVT_TASK_NOTIFY_WAIT         ( 16 ) // obj: current TCB, arg: index
+#define traceEVT_TICK                     ( 17 ) // arg: tick count
+#define traceEVT_ISR_ENTER                ( 18 ) // arg: mcause (lowest 5 bits)
+#define traceEVT_ISR_EXIT                 ( 19 )
+#define traceEVT_ISR_EXIT_TO_SCHEDULER    ( 20 )
+
+typedef struct {
+  uint32_t ulTime;
+  uint32_t ulEvent;
+  uint32_t ulObject;
+} TraceRecord_t;
+
+extern TraceRecord_t xTraceBuffer[configTRACE_BUFFER_RECORDS];
+extern volatile uint32_t ulTraceIndex;
+extern volatile uint32_t ulTraceEnabled;
+
+void vTraceInit(void);
+void vTraceDump(void);
+
+
+/******************************************************************************
+ * Append a record. Safe to be called from any context.
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vTraceRecord(uint32_t ulEvent, uint32_t ulArg, const void *pvObject) {
+
+  TraceRecord_t *pxRecord;
+  uint32_t ulStatus, ulIndex;
+
+  ulStatus = ulIrqMaskSave();
+  if (ulTraceEnabled) {
+    ulIndex = ulTraceIndex;
+    ulTraceIndex = ulIndex + 1;
+    pxRecord = &xTraceBuffer[ulIndex & (configTRACE_BUFFER_RECORDS - 1)];
+    pxRecord->ulTime = *(volatile uint32_t *)(configMTIME_BASE_ADDRESS);
+    pxRecord->ulEvent = ulEvent | (ulArg << 8);
+    pxRecord->ulObject = (uint32_t)pvObject;
+  }
+  vIrqMaskRestore(ulStatus);
+}
+
+/* Kernel hooks; pxCurrentTCB and pxTCB are only valid within tasks.c */
+#define traceTASK_SWITCHED_IN()                        do { vTraceRecord(traceEVT_TASK_SWITCHED_IN, pxCurrentTCB->uxPriority, pxCurrentTCB); \
+                                                            stackguardTASK_SWITCHED_IN(); } while (0)
+#define traceTASK_CREATE(pxNewTCB)                     vTraceRecord(traceEVT_TASK_CREATE, (pxNewTCB)->uxPriority, pxNewTCB)
+#define traceTASK_DELETE(pxTaskToDelete)               vTraceRecord(traceEVT_TASK_DELETE, 0, pxTaskToDelete)
+#define traceTASK_DELAY()                              vTraceRecord(traceEVT_TASK_DELAY, 0, pxCurrentTCB)
+#define traceTASK_DELAY_UNTIL(xTimeToWake)             vTraceRecord(traceEVT_TASK_DELAY_UNTIL, (uint32_t)(xTimeToWake), pxCurrentTCB)
+#define traceQUEUE_SEND(pxQueue)                       vTraceRecord(traceEVT_QUEUE_SEND, 0, pxQueue)
+#define traceQUEUE_SEND_FAILED(pxQueue)                vTraceRecord(traceEVT_QUEUE_SEND_FAILED, 0, pxQueue)
+#define traceQUEUE_RECEIVE(pxQueue)                    vTraceRecord(traceEVT_QUEUE_RECEIVE, 0, pxQueue)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)             vTraceRecord(traceEVT_QUEUE_RECEIVE_FAILED, 0, pxQueue)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)           vTraceRecord(traceEVT_BLOCKING_ON_QUEUE_SEND, 0, pxQueue)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)        vTraceRecord(traceEVT_BLOCKING_ON_QUEUE_RECV, 0, pxQueue)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)              vTraceRecord(traceEVT_QUEUE_SEND_FROM_ISR, 0, pxQueue)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)           vTraceRecord(traceEVT_QUEUE_RECEIVE_FROM_ISR, 0, pxQueue)
+#define traceTASK_NOTIFY(uxIndexToNotify)              vTraceRecord(traceEVT_TASK_NOTIFY, uxIndexToNotify, pxTCB)
+#define traceTASK_NOTIFY_FROM_ISR(uxIndexToNotify)     vTraceRecord(traceEVT_TASK_NOTIFY_FROM_ISR, uxIndexToNotify, pxTCB)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR(uxIndexToNotify) vTraceRecord(traceEVT_TASK_NOTIFY_FROM_ISR, uxIndexToNotify, pxTCB)
+#define traceTASK_NOTIFY_WAIT_BLOCK(uxIndexToWait)     vTraceRecord(traceEVT_TASK_NOTIFY_WAIT, uxIndexToWait, pxCurrentTCB)
+#define traceTASK_NOTIFY_TAKE_BLOCK(uxIndexToWait)     vTraceRecord(traceEVT_TASK_NOTIFY_WAIT, uxIndexToWait, pxCurrentTCB)
+#define traceTASK_INCREMENT_TICK(xTickCount)           vTraceRecord(traceEVT_TICK, (uint32_t)(xTickCount), 0)
+#define traceISR_EXIT_TO_SCHEDULER()                   vTraceRecord(traceEVT_ISR_EXIT_TO_SCHEDULER, 0, 0)
+
+/* Application interrupt handler hooks (see main.c) */
+#define traceNEORV32_ISR_ENTER(ulCause)                vTraceRecord(traceEVT_ISR_ENTER, (ulCause) & 0x1f, 0)
+#define traceNEORV32_ISR_EXIT()                        vTraceRecord(traceEVT_ISR_EXIT, 0, 0)
+
+#else
+
+#define traceTASK_SWITCHED_IN()                        stackguardTASK_SWITCHED_IN()
+#define vTraceInit()
+#define traceNEORV32_ISR_ENTER(ulCause)
+#define traceNEORV32_ISR_EXIT()
+
+#endif /* configUSE_TRACE_RECORDER */
+
+#endif /* TRACE_H */